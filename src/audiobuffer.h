@@ -30,7 +30,10 @@
  * An AudioBuffer represents multiple channels of audio
  * each of equal buffer length.
  * AudioBuffer has convenience methods for cloning, silencing and mixing
+ *
+ * SampleType describes the precision of the buffers contents (e.g. float or double)
  */
+template <typename SampleType>
 class AudioBuffer
 {
     public:
@@ -41,7 +44,7 @@ class AudioBuffer
         int bufferSize;
         bool loopeable;
 
-        float* getBufferForChannel( int aChannelNum );
+        SampleType* getBufferForChannel( int aChannelNum );
         int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
         void silenceBuffers();
         void adjustBufferVolumes( float volume );
@@ -49,7 +52,9 @@ class AudioBuffer
         AudioBuffer* clone();
 
     protected:
-        std::vector<float*>* _buffers;
+        std::vector<SampleType*>* _buffers;
 };
 
+#include "audiobuffer.tcc"
+
 #endif
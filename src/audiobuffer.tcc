@@ -20,11 +20,11 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
-#include "audiobuffer.h"
 #include <algorithm>
 #include <string.h>
 
-AudioBuffer::AudioBuffer( int aAmountOfChannels, int aBufferSize )
+template <typename SampleType>
+AudioBuffer<SampleType>::AudioBuffer( int aAmountOfChannels, int aBufferSize )
 {
     loopeable        = false;
     amountOfChannels = aAmountOfChannels;
@@ -32,17 +32,18 @@ AudioBuffer::AudioBuffer( int aAmountOfChannels, int aBufferSize )
 
     // create silent buffers for each channel
 
-    _buffers = new std::vector<float*>( amountOfChannels );
+    _buffers = new std::vector<SampleType*>( amountOfChannels );
 
     // fill buffers with silence
 
     for ( int i = 0; i < amountOfChannels; ++i ) {
-        _buffers->at( i ) = new float[ aBufferSize ];
-        memset( _buffers->at( i ), 0, aBufferSize * sizeof( float )); // zero bits should equal 0.f
+        _buffers->at( i ) = new SampleType[ aBufferSize ];
+        memset( _buffers->at( i ), 0, aBufferSize * sizeof( SampleType )); // zero bits should equal 0
     }
 }
 
-AudioBuffer::~AudioBuffer()
+template <typename SampleType>
+AudioBuffer<SampleType>::~AudioBuffer()
 {
     while ( !_buffers->empty()) {
         delete[] _buffers->back(), _buffers->pop_back();
@@ -52,12 +53,14 @@ AudioBuffer::~AudioBuffer()
 
 /* public methods */
 
-float* AudioBuffer::getBufferForChannel( int aChannelNum )
+template <typename SampleType>
+SampleType* AudioBuffer<SampleType>::getBufferForChannel( int aChannelNum )
 {
     return _buffers->at( aChannelNum );
 }
 
-int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume )
+template <typename SampleType>
+int AudioBuffer<SampleType>::mergeBuffers( AudioBuffer<SampleType>* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume )
 {
     if ( aBuffer == 0 || aWriteOffset >= bufferSize )
         return 0;
@@ -80,8 +83,8 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
         if ( c > maxSourceChannel )
             break;
 
-        float* srcBuffer    = aBuffer->getBufferForChannel( c );
-        float* targetBuffer = getBufferForChannel( c );
+        SampleType* srcBuffer    = aBuffer->getBufferForChannel( c );
+        SampleType* targetBuffer = getBufferForChannel( c );
 
         for ( int i = aWriteOffset, r = aReadOffset; i < maxWriteOffset; ++i, ++r )
         {
@@ -104,48 +107,52 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
  * fills the buffers with silence
  * clearing their previous contents
  */
-void AudioBuffer::silenceBuffers()
+template <typename SampleType>
+void AudioBuffer<SampleType>::silenceBuffers()
 {
-    // use mem set to quickly erase existing buffer contents, zero bits should equal 0.f
+    // use mem set to quickly erase existing buffer contents, zero bits should equal 0
     for ( int i = 0; i < amountOfChannels; ++i )
-        memset( getBufferForChannel( i ), 0, bufferSize * sizeof( float ));
+        memset( getBufferForChannel( i ), 0, bufferSize * sizeof( SampleType ));
 }
 
-void AudioBuffer::adjustBufferVolumes( float amp )
+template <typename SampleType>
+void AudioBuffer<SampleType>::adjustBufferVolumes( float amp )
 {
     for ( int i = 0; i < amountOfChannels; ++i )
     {
-        float* buffer = getBufferForChannel( i );
+        SampleType* buffer = getBufferForChannel( i );
 
         for ( int j = 0; j < bufferSize; ++j )
             buffer[ j ] *= amp;
     }
 }
 
-bool AudioBuffer::isSilent()
+template <typename SampleType>
+bool AudioBuffer<SampleType>::isSilent()
 {
     for ( int i = 0; i < amountOfChannels; ++i )
     {
-        float* buffer = getBufferForChannel( i );
+        SampleType* buffer = getBufferForChannel( i );
         for ( int j = 0; j < bufferSize; ++j )
         {
-            if ( buffer[ j ] != 0.f )
+            if ( buffer[ j ] != ( SampleType ) 0 )
                 return false;
         }
     }
     return true;
 }
 
-AudioBuffer* AudioBuffer::clone()
+template <typename SampleType>
+AudioBuffer<SampleType>* AudioBuffer<SampleType>::clone()
 {
-    AudioBuffer* output = new AudioBuffer( amountOfChannels, bufferSize );
+    AudioBuffer<SampleType>* output = new AudioBuffer<SampleType>( amountOfChannels, bufferSize );
 
     for ( int i = 0; i < amountOfChannels; ++i )
     {
-        float* sourceBuffer = getBufferForChannel( i );
-        float* targetBuffer = output->getBufferForChannel( i );
+        SampleType* sourceBuffer = getBufferForChannel( i );
+        SampleType* targetBuffer = output->getBufferForChannel( i );
 
-        memcpy( targetBuffer, sourceBuffer, bufferSize * sizeof( float ));
+        memcpy( targetBuffer, sourceBuffer, bufferSize * sizeof( SampleType ));
     }
     return output;
 }
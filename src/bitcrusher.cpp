@@ -58,12 +58,14 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
 
     bool hadChange = ( wasEnabled != enabled ) || _lfoDepth != LFODepth;
 
-    if ( enabled )
+    if ( enabled ) {
         lfo->setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
         );
+        lfo->setSyncedRate( LFORatePercentage );
+    }
 
     // turning LFO off
     if ( !hasLFO && wasEnabled ) {
@@ -77,31 +79,52 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
     }
 }
 
-void BitCrusher::process( float* inBuffer, int bufferSize )
+void BitCrusher::prepare( int bufferSize )
 {
-    // sound should not be crushed ? do nothing
-    if ( _bits == 16 && !hasLFO )
+    _isModulated = hasLFO || !_amountChanges.empty();
+
+    if ( !_isModulated )
         return;
 
-    int bitsPlusOne = _bits + 1;
+    if (( int ) _bitsPerSample.size() < bufferSize ) {
+        _bitsPerSample.resize( bufferSize );
+        _outputMixPerSample.resize( bufferSize );
+        _lfoValues.resize( bufferSize );
+    }
+
+    if ( hasLFO )
+        lfo->render( _lfoValues.data(), bufferSize );
+
+    size_t change = 0;
 
     for ( int i = 0; i < bufferSize; ++i )
     {
-        short input = ( short ) (( inBuffer[ i ] * _inputMix ) * SHRT_MAX );
-        short prevent_offset = ( short )( -1 >> bitsPlusOne );
-        input &= ( -1 << ( 16 - _bits ));
-        inBuffer[ i ] = (( input + prevent_offset ) * _outputMix ) / SHRT_MAX;
-
-        if ( hasLFO ) {
-            // multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
-            float lfoValue = lfo->peek() * .5f  + .5f;
-            _tempAmount = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
-
-            // recalculate the current resolution
-            calcBits();
-            bitsPlusOne = _bits + 1;
+        // apply the amounts scheduled for the current sample
+
+        while ( change < _amountChanges.size() && _amountChanges[ change ].offset <= i ) {
+            setAmount( _amountChanges[ change ].amount );
+            setOutputMix( _amountChanges[ change ].outputMix );
+            ++change;
         }
+        _bitsPerSample[ i ]      = _bits;
+        _outputMixPerSample[ i ] = _outputMix;
+
+        if ( !hasLFO )
+            continue;
+
+        // multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
+        float lfoValue = _lfoValues[ i ] * .5f  + .5f;
+        _tempAmount = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+
+        // recalculate the current resolution
+        calcBits();
     }
+    _amountChanges.clear();
+}
+
+void BitCrusher::scheduleAmount( int offset, float amount, float outputMix )
+{
+    _amountChanges.push_back({ offset, amount, outputMix });
 }
 
 /* setters */
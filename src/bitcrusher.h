@@ -24,6 +24,7 @@
 #define __BITCRUSHER_H_INCLUDED__
 
 #include "lfo.h"
+#include <vector>
 
 namespace Igorski {
 class BitCrusher {
@@ -33,7 +34,23 @@ class BitCrusher {
         ~BitCrusher();
 
         void setLFO( float LFORatePercentage, float LFODepth );
-        void process( float* inBuffer, int bufferSize );
+
+        // runs the oscillator and applies the scheduled amounts (see scheduleAmount()) for given bufferSize, caching
+        // the resolution for each sample. Should be invoked once per process cycle before processing the individual channels
+
+        void prepare( int bufferSize );
+
+        // schedules given amount and output mix to apply from given sample offset within the next process cycle, so
+        // control rate modulation can change the resolution within a process cycle. Changes must be scheduled in order of their offset
+
+        void scheduleAmount( int offset, float amount, float outputMix );
+
+        // applies the bit crusher onto given buffer. As this does not modify the crushers
+        // state, it is safe to invoke for multiple channels (in parallel). When given buffer
+        // is oversampled, each resolution calculated by prepare() applies to oversamplingFactor samples
+
+        template <typename SampleType>
+        void process( SampleType* inBuffer, int bufferSize, int oversamplingFactor = 1 );
 
         void setAmount( float value ); // range between -1 to +1
         void setInputMix( float value );
@@ -55,7 +72,23 @@ class BitCrusher {
         float _lfoRange;
         float _lfoMax;
         float _lfoMin;
+
+        // the amounts scheduled for the next process cycle (see scheduleAmount())
+
+        struct AmountChange {
+            int offset;
+            float amount;
+            float outputMix;
+        };
+        std::vector<AmountChange> _amountChanges;
+
+        bool _isModulated = false;            // whether the resolution varies within the current process cycle
+        std::vector<int> _bitsPerSample;      // the resolution for each sample of the current process cycle (when modulated)
+        std::vector<float> _outputMixPerSample;
+        std::vector<float> _lfoValues;        // the oscillators value for each sample of the current process cycle
 };
 }
 
+#include "bitcrusher.tcc"
+
 #endif
@@ -0,0 +1,55 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013-2018 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <limits.h>
+
+namespace Igorski {
+
+template <typename SampleType>
+void BitCrusher::process( SampleType* inBuffer, int bufferSize, int oversamplingFactor )
+{
+    // sound should not be crushed ? do nothing
+    if ( _bits == 16 && !_isModulated )
+        return;
+
+    int bits = _bits;
+    float outputMix = _outputMix;
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        if ( _isModulated ) {
+            bits      = _bitsPerSample[ i / oversamplingFactor ];
+            outputMix = _outputMixPerSample[ i / oversamplingFactor ];
+
+            // when not oscillating, the sound is not crushed at full resolution (as when not modulated)
+            if ( bits == 16 && !hasLFO )
+                continue;
+        }
+
+        short input = ( short ) (( inBuffer[ i ] * _inputMix ) * SHRT_MAX );
+        short prevent_offset = ( short )( -1 >> ( bits + 1 ));
+        input &= ( -1 << ( 16 - bits ));
+        inBuffer[ i ] = (( SampleType ) ( input + prevent_offset ) * outputMix ) / SHRT_MAX;
+    }
+}
+
+}
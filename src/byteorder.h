@@ -0,0 +1,65 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __BYTEORDER_H_INCLUDED__
+#define __BYTEORDER_H_INCLUDED__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Igorski {
+namespace ByteOrder {
+
+    // (de)serialization of values in little endian byte order, regardless of the platforms byte order
+
+    inline uint32_t readUint32( const uint8_t* data )
+    {
+        return ( uint32_t ) data[ 0 ] | (( uint32_t ) data[ 1 ] << 8 ) | (( uint32_t ) data[ 2 ] << 16 ) | (( uint32_t ) data[ 3 ] << 24 );
+    }
+
+    inline float readFloat( const uint8_t* data )
+    {
+        uint32_t bits = readUint32( data );
+        float value;
+        memcpy( &value, &bits, sizeof( float ));
+        return value;
+    }
+
+    inline void writeUint32( std::vector<uint8_t>& data, uint32_t value )
+    {
+        data.push_back(( uint8_t ) value );
+        data.push_back(( uint8_t ) ( value >> 8 ));
+        data.push_back(( uint8_t ) ( value >> 16 ));
+        data.push_back(( uint8_t ) ( value >> 24 ));
+    }
+
+    inline void writeFloat( std::vector<uint8_t>& data, float value )
+    {
+        uint32_t bits;
+        memcpy( &bits, &value, sizeof( float ));
+        writeUint32( data, bits );
+    }
+}
+}
+
+#endif
@@ -25,15 +25,23 @@
 
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include "global.h"
+#include "denormalguard.h"
 
 /***
  * Taken from JUCE library
  * This macro can be applied to a float variable to check whether it contains a denormalised value, and to normalise it if necessary.
  * On CPUs that aren't vulnerable to denormalisation problems, this will have no effect.
- * This activates the Flush To Zero(FTZ) and Denormals Are Zero (DAZ) mode for x86 and x64
+ * When the CPU supports Flush To Zero(FTZ) and Denormals Are Zero (DAZ) modes, these are activated for the
+ * duration of the process cycle instead (see DenormalGuard) and this macro is compiled out
  */
+#ifdef DENORMAL_GUARD_SUPPORTED
+#define UNDENORMALISE(x) {}
+#else
 #define UNDENORMALISE(x) { (x) += 0.1f; (x) -= 0.1f; }
+#endif
 
 /**
  * convenience utilities to process values
@@ -123,6 +131,42 @@ namespace Calc {
     {
         return pow( base, value );
     }
+
+    // approximates 1 / value for positive, normal values without using a division (which
+    // stalls the pipeline and prevents the compiler from vectorizing the surrounding loop)
+    // an initial estimate is derived from the exponent bits and refined using Newton-Raphson
+    // iterations, bounding the relative error to 1e-5 for floats and 1e-10 for doubles
+
+    inline float reciprocal( float value )
+    {
+        uint32_t bits;
+        std::memcpy( &bits, &value, sizeof( float ));
+        bits = 0x7EF311C7u - bits;
+
+        float out;
+        std::memcpy( &out, &bits, sizeof( float ));
+
+        out = out * ( 2.f - value * out );
+        out = out * ( 2.f - value * out );
+
+        return out;
+    }
+
+    inline double reciprocal( double value )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &value, sizeof( double ));
+        bits = 0x7FDE623822FC16E6ull - bits;
+
+        double out;
+        std::memcpy( &out, &bits, sizeof( double ));
+
+        out = out * ( 2.0 - value * out );
+        out = out * ( 2.0 - value * out );
+        out = out * ( 2.0 - value * out );
+
+        return out;
+    }
 }
 }
 
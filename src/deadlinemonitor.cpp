@@ -0,0 +1,121 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "deadlinemonitor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+DeadlineMonitor::DeadlineMonitor()
+{
+    clear();
+}
+
+DeadlineMonitor::~DeadlineMonitor()
+{
+
+}
+
+/* public methods */
+
+void DeadlineMonitor::end( int numSamples, double sampleRate )
+{
+    if ( numSamples <= 0 || sampleRate <= 0.0 ) {
+        return;
+    }
+
+    double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - _start ).count();
+    double budget  = ( double ) numSamples / sampleRate;
+    double load    = elapsed / budget;
+
+    if ( _resetRequested.exchange( false, std::memory_order_acquire )) {
+        clear();
+    }
+
+    increment( _blocks );
+
+    if ( load > .5 ) {
+        increment( _blocksOverHalfBudget );
+    }
+    if ( load > 1.0 ) {
+        increment( _blocksOverBudget );
+    }
+    if ( load > _worstLoad.load( std::memory_order_relaxed )) {
+        _worstLoad.store( load, std::memory_order_relaxed );
+    }
+
+    // the exponent of the load (where 1.0 has exponent 1) determines the bucket
+
+    int exponent = 0;
+    int bucket   = 0;
+
+    if ( load > 0.0 ) {
+        frexp( load, &exponent );
+        bucket = std::min( HISTOGRAM_BUCKETS - 1, std::max( 0, exponent - 1 + BUDGET_BUCKET ));
+    }
+
+    increment( _histogram[ bucket ]);
+}
+
+DeadlineMonitor::Statistics DeadlineMonitor::getStatistics() const
+{
+    Statistics statistics;
+
+    statistics.blocks               = _blocks.load( std::memory_order_relaxed );
+    statistics.blocksOverHalfBudget = _blocksOverHalfBudget.load( std::memory_order_relaxed );
+    statistics.blocksOverBudget     = _blocksOverBudget.load( std::memory_order_relaxed );
+    statistics.worstLoad            = _worstLoad.load( std::memory_order_relaxed );
+
+    for ( int i = 0; i < HISTOGRAM_BUCKETS; ++i ) {
+        statistics.histogram[ i ] = _histogram[ i ].load( std::memory_order_relaxed );
+    }
+    return statistics;
+}
+
+void DeadlineMonitor::reset()
+{
+    _resetRequested.store( true, std::memory_order_release );
+}
+
+double DeadlineMonitor::getBucketLoad( int bucket )
+{
+    return bucket <= 0 ? 0.0 : ldexp( 1.0, bucket - BUDGET_BUCKET );
+}
+
+/* private methods */
+
+void DeadlineMonitor::clear()
+{
+    _blocks.store( 0, std::memory_order_relaxed );
+    _blocksOverHalfBudget.store( 0, std::memory_order_relaxed );
+    _blocksOverBudget.store( 0, std::memory_order_relaxed );
+    _worstLoad.store( 0.0, std::memory_order_relaxed );
+
+    for ( auto& bucket : _histogram ) {
+        bucket.store( 0, std::memory_order_relaxed );
+    }
+}
+
+}
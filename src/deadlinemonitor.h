@@ -0,0 +1,106 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DEADLINEMONITOR_H_INCLUDED__
+#define __DEADLINEMONITOR_H_INCLUDED__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Igorski {
+/**
+ * A DeadlineMonitor measures the (wall clock) time spent processing each block
+ * against the real-time budget of the block (e.g. the duration of its samples),
+ * as it is the slowest block that causes audible dropouts.
+ *
+ * The process thread measures the blocks using begin() and end() while the
+ * statistics can be read from any thread without locking (see getStatistics())
+ */
+class DeadlineMonitor
+{
+    public:
+        // the histogram has a bucket for each power of two of the load (time spent relative to the budget)
+        // bucket 0 holds all loads below 1/128th of the budget, the last bucket all loads of 4x the budget and above
+
+        static constexpr int HISTOGRAM_BUCKETS = 11;
+        static constexpr int BUDGET_BUCKET     = 8; // the bucket holding the loads between 1x and 2x the budget
+
+        // messages exchanged with the controller, the controller requests the statistics
+        // which are sent in response (as the process thread should not send messages)
+
+        static constexpr const char* REQUEST_MESSAGE    = "DeadlineStatisticsRequest";
+        static constexpr const char* STATISTICS_MESSAGE = "DeadlineStatistics";
+        static constexpr const char* STATISTICS_DATA    = "Statistics"; // binary attribute holding the Statistics
+
+        struct Statistics {
+            uint64_t blocks;
+            uint64_t blocksOverHalfBudget; // blocks that took more than 50% of their budget
+            uint64_t blocksOverBudget;     // blocks that took longer than their budget (e.g. a deadline miss)
+            double worstLoad;              // time spent relative to the budget, of the slowest block
+            uint64_t histogram[ HISTOGRAM_BUCKETS ];
+        };
+
+        DeadlineMonitor();
+        ~DeadlineMonitor();
+
+        // to be invoked by the process thread at the start and end of each block
+
+        inline void begin() {
+            _start = std::chrono::steady_clock::now();
+        }
+        void end( int numSamples, double sampleRate );
+
+        // retrieves the current statistics (can be invoked from any thread)
+
+        Statistics getStatistics() const;
+
+        // requests all statistics to be cleared upon the end of the next block (can be invoked from any thread)
+
+        void reset();
+
+        // the lowest load (relative to the budget) of given histogram bucket (0 for the first bucket)
+
+        static double getBucketLoad( int bucket );
+
+    private:
+        std::chrono::steady_clock::time_point _start;
+
+        // the statistics are only written by the process thread, as such the values
+        // need not be atomically incremented (but are atomic so they can be read while processing)
+
+        std::atomic<uint64_t> _blocks{ 0 };
+        std::atomic<uint64_t> _blocksOverHalfBudget{ 0 };
+        std::atomic<uint64_t> _blocksOverBudget{ 0 };
+        std::atomic<double>   _worstLoad{ 0.0 };
+        std::atomic<uint64_t> _histogram[ HISTOGRAM_BUCKETS ];
+        std::atomic<bool>     _resetRequested{ false };
+
+        static inline void increment( std::atomic<uint64_t>& value ) {
+            value.store( value.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        }
+
+        void clear();
+};
+}
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "decimationfilter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+DecimationFilter::DecimationFilter()
+{
+
+}
+
+DecimationFilter::~DecimationFilter()
+{
+
+}
+
+/* public methods */
+
+void DecimationFilter::prepare( int maxRatio )
+{
+    maxRatio = std::max( 1, maxRatio );
+
+    if ( maxRatio <= _maxRatio && !_kernels.empty()) {
+        return; // kernels have been calculated
+    }
+
+    _kernels.resize( maxRatio + 1 );
+
+    for ( int ratio = 2; ratio <= maxRatio; ++ratio ) {
+        createKernel( ratio, _kernels[ ratio ]);
+    }
+    _maxRatio = maxRatio;
+}
+
+int DecimationFilter::getMaxRatio()
+{
+    return _maxRatio;
+}
+
+int DecimationFilter::getDelay( int ratio )
+{
+    ratio = std::min( _maxRatio, std::max( 1, ratio ));
+    return ratio == 1 ? 0 : (( int ) _kernels[ ratio ].size() - 1 ) / 2;
+}
+
+/* private methods */
+
+void DecimationFilter::createKernel( int ratio, std::vector<float>& kernel )
+{
+    const double PI = 3.141592653589793;
+
+    int length = TAPS_PER_RATIO * ratio + 1;
+    int center = length / 2;
+
+    // the transition band (relative to the sampling rate) spans from the end of the passband
+    // up until the Nyquist frequency of the decimated signal, the cutoff lies at its center
+
+    double passband   = 0.4 / ( double ) ratio;
+    double stopband   = 0.5 / ( double ) ratio;
+    double cutoff     = ( passband + stopband ) * 0.5;
+    double transition = stopband - passband;
+
+    // the attenuation the kernel length allows for given transition width, and the Kaiser window
+    // shape (beta) providing it (see Kaiser's design formulas)
+
+    double attenuation = 14.36 * transition * ( double ) ( length - 1 ) + 7.95;
+    double beta = attenuation > 50.0 ? 0.1102 * ( attenuation - 8.7 ) :
+                  attenuation > 21.0 ? 0.5842 * pow( attenuation - 21.0, 0.4 ) + 0.07886 * ( attenuation - 21.0 ) : 0.0;
+
+    double sum = 0.0;
+
+    std::vector<double> coefficients( length );
+
+    for ( int i = 0; i < length; ++i ) {
+        double x    = ( double ) ( i - center );
+        double sinc = ( i == center ) ? 2.0 * cutoff : sin( 2.0 * PI * cutoff * x ) / ( PI * x );
+
+        // Kaiser window
+
+        double position = x / ( double ) center; // -1 to +1 range
+        double window   = bessel( beta * sqrt( std::max( 0.0, 1.0 - position * position ))) / bessel( beta );
+
+        coefficients[ i ] = sinc * window;
+        sum += coefficients[ i ];
+    }
+
+    // normalize for unity gain at DC and store in reverse order (see apply())
+
+    kernel.resize( length );
+
+    for ( int i = 0; i < length; ++i ) {
+        kernel[ length - 1 - i ] = ( float ) ( coefficients[ i ] / sum );
+    }
+}
+
+double DecimationFilter::bessel( double x )
+{
+    // zeroth order modified Bessel function of the first kind (power series)
+
+    double sum  = 1.0;
+    double term = 1.0;
+
+    for ( int k = 1; k < 64; ++k ) {
+        term *= ( x / ( 2.0 * k )) * ( x / ( 2.0 * k ));
+        sum  += term;
+
+        if ( term < sum * 1e-12 ) {
+            break;
+        }
+    }
+    return sum;
+}
+
+}
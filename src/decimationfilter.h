@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DECIMATIONFILTER_H_INCLUDED__
+#define __DECIMATIONFILTER_H_INCLUDED__
+
+#include <vector>
+
+namespace Igorski {
+/**
+ * A DecimationFilter is a linear phase (windowed sinc) FIR lowpass filter used to
+ * remove the content above the Nyquist frequency of a decimated signal prior to
+ * sample and hold. As only the held samples are required, the filter is only
+ * evaluated at the positions being read (rather than filtering every incoming sample).
+ *
+ * A kernel is calculated for each integer decimation ratio up to the provided maximum. The
+ * kernels are Kaiser windowed, with the passband ending at 0.4 and the stopband starting at
+ * 0.5 times the Nyquist frequency of the decimated signal (e.g. aliasing is attenuated by over 50 dB)
+ */
+class DecimationFilter
+{
+    public:
+        // the kernel length is proportional to the decimation ratio (so the cost per output sample remains constant)
+        // as the transition band narrows with the ratio, this determines the stopband attenuation (see createKernel())
+        static constexpr int TAPS_PER_RATIO = 32;
+
+        DecimationFilter();
+        ~DecimationFilter();
+
+        // calculates the kernels for all ratios up to given maxRatio (not during processing!)
+
+        void prepare( int maxRatio );
+
+        int getMaxRatio();
+
+        // the delay (in samples) introduced by the kernel for given ratio
+
+        int getDelay( int ratio );
+
+        /**
+         * calculate the filtered value of the sample at given position of given
+         * (circular) buffer, for given decimation ratio
+         */
+        template <typename SampleType>
+        inline SampleType apply( const SampleType* buffer, int bufferSize, int position, int ratio ) {
+            ratio = ratio < 1 ? 1 : ( ratio > _maxRatio ? _maxRatio : ratio );
+
+            if ( ratio == 1 ) {
+                return buffer[ position ];
+            }
+
+            const std::vector<float>& kernel = _kernels[ ratio ];
+            int length = ( int ) kernel.size();
+            int start  = position - length + 1;
+
+            // the kernel is stored in reverse, meaning it can be multiplied with the buffer
+            // in ascending order. When the kernel spans the start of the circular buffer, the
+            // first part is read from the end of the buffer
+
+            if ( start >= 0 ) {
+                return dotProduct( kernel.data(), buffer + start, length );
+            }
+            int wrapped = -start;
+            return dotProduct( kernel.data(), buffer + bufferSize - wrapped, wrapped ) +
+                   dotProduct( kernel.data() + wrapped, buffer, length - wrapped );
+        }
+
+    private:
+        int _maxRatio = 1;
+        std::vector<std::vector<float>> _kernels; // reversed kernel for each ratio (indices 0 and 1 are unused)
+
+        void createKernel( int ratio, std::vector<float>& kernel );
+        static double bessel( double x );
+
+        // multiple partial sums allow the compiler to vectorize the summation
+        // (which it otherwise cannot without relaxing floating point rules)
+
+        template <typename SampleType>
+        inline SampleType dotProduct( const float* a, const SampleType* b, int length ) {
+            SampleType sums[ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            int i = 0;
+
+            for ( ; i <= length - 8; i += 8 ) {
+                for ( int j = 0; j < 8; ++j ) {
+                    sums[ j ] += a[ i + j ] * b[ i + j ];
+                }
+            }
+            for ( ; i < length; ++i ) {
+                sums[ 0 ] += a[ i ] * b[ i ];
+            }
+            return (( sums[ 0 ] + sums[ 1 ]) + ( sums[ 2 ] + sums[ 3 ])) +
+                   (( sums[ 4 ] + sums[ 5 ]) + ( sums[ 6 ] + sums[ 7 ]));
+        }
+};
+}
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DENORMALGUARD_H_INCLUDED__
+#define __DENORMALGUARD_H_INCLUDED__
+
+#include <cstdint>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+    #include <xmmintrin.h>
+    #define DENORMAL_GUARD_SSE
+#elif defined( _M_ARM64 )
+    #include <intrin.h>
+    #define DENORMAL_GUARD_MSVC_ARM64
+#elif defined( __aarch64__ )
+    #define DENORMAL_GUARD_AARCH64
+#endif
+
+#if defined( DENORMAL_GUARD_SSE ) || defined( DENORMAL_GUARD_MSVC_ARM64 ) || defined( DENORMAL_GUARD_AARCH64 )
+    #define DENORMAL_GUARD_SUPPORTED
+#endif
+
+namespace Igorski {
+/**
+ * A DenormalGuard enables the flush-to-zero and denormals-are-zero modes of the CPU
+ * for the lifetime of the instance, restoring the previous modes upon destruction.
+ *
+ * Calculations on denormal (extremely small) numbers can be very slow. Within the guarded
+ * scope, denormal results and inputs are treated as zero by the CPU, so the process routines
+ * need not normalise their values. Note the floating point modes apply to the current thread only.
+ *
+ * On unsupported architectures this does nothing (see UNDENORMALISE in calc.h)
+ */
+class DenormalGuard
+{
+    public:
+        DenormalGuard() {
+            _state = getState();
+            setState( _state | FLUSH_MASK );
+        }
+
+        ~DenormalGuard() {
+            setState( _state );
+        }
+
+    private:
+#if defined( DENORMAL_GUARD_SSE )
+        static constexpr uint64_t FLUSH_MASK = 0x8040; // MXCSR flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+
+        static inline uint64_t getState() {
+            return _mm_getcsr();
+        }
+
+        static inline void setState( uint64_t state ) {
+            _mm_setcsr(( unsigned int ) state );
+        }
+#elif defined( DENORMAL_GUARD_MSVC_ARM64 )
+        static constexpr uint64_t FLUSH_MASK = 1 << 24; // FPCR flush-to-zero (bit 24, applies to inputs and results)
+
+        static inline uint64_t getState() {
+            return ( uint64_t ) _ReadStatusReg( ARM64_FPCR );
+        }
+
+        static inline void setState( uint64_t state ) {
+            _WriteStatusReg( ARM64_FPCR, ( __int64 ) state );
+        }
+#elif defined( DENORMAL_GUARD_AARCH64 )
+        static constexpr uint64_t FLUSH_MASK = 1 << 24; // FPCR flush-to-zero (bit 24, applies to inputs and results)
+
+        static inline uint64_t getState() {
+            uint64_t state;
+            __asm__ __volatile__( "mrs %0, fpcr" : "=r"( state ));
+            return state;
+        }
+
+        static inline void setState( uint64_t state ) {
+            __asm__ __volatile__( "msr fpcr, %0" : : "r"( state ));
+        }
+#else
+        static constexpr uint64_t FLUSH_MASK = 0;
+
+        static inline uint64_t getState() {
+            return 0;
+        }
+
+        static inline void setState( uint64_t state ) {
+            // unsupported architecture
+        }
+#endif
+        uint64_t _state;
+};
+}
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "envelopefollower.h"
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+EnvelopeFollower::EnvelopeFollower()
+{
+    cacheCoefficients();
+}
+
+EnvelopeFollower::~EnvelopeFollower()
+{
+
+}
+
+/* public methods */
+
+void EnvelopeFollower::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+    cacheCoefficients();
+}
+
+void EnvelopeFollower::setAttack( float milliseconds )
+{
+    _attackTime = milliseconds;
+    cacheCoefficients();
+}
+
+void EnvelopeFollower::setRelease( float milliseconds )
+{
+    _releaseTime = milliseconds;
+    cacheCoefficients();
+}
+
+void EnvelopeFollower::reset()
+{
+    _envelope = 0.f;
+    _peak     = 0.f;
+    _position = 0;
+}
+
+float EnvelopeFollower::getEnvelope()
+{
+    return _envelope;
+}
+
+int EnvelopeFollower::getSamplesUntilTick()
+{
+    return CONTROL_RATE - _position;
+}
+
+/* private methods */
+
+void EnvelopeFollower::cacheCoefficients()
+{
+    // one pole smoothing, where the time constants are expressed in control rate ticks
+
+    float ticksPerMs = _sampleRate / ( 1000.f * CONTROL_RATE );
+
+    _attack  = exp( -1.f / std::fmax( 1.f, _attackTime  * ticksPerMs ));
+    _release = exp( -1.f / std::fmax( 1.f, _releaseTime * ticksPerMs ));
+}
+
+void EnvelopeFollower::tick()
+{
+    float coefficient = _peak > _envelope ? _attack : _release;
+
+    _envelope = _peak + coefficient * ( _envelope - _peak );
+    _peak     = 0.f;
+    _position = 0;
+}
+
+}
@@ -0,0 +1,79 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ENVELOPEFOLLOWER_H_INCLUDED__
+#define __ENVELOPEFOLLOWER_H_INCLUDED__
+
+namespace Igorski {
+/**
+ * Follows the peak level of a (side chain) signal. The input is only inspected and never
+ * copied, so it can be read directly from the host buffers. The envelope is updated at
+ * control rate (once every CONTROL_RATE samples, counted across process cycles) which
+ * keeps its value independent of the block size the host processes in.
+ */
+class EnvelopeFollower
+{
+    public:
+        static const int CONTROL_RATE = 32; // in samples
+
+        EnvelopeFollower();
+        ~EnvelopeFollower();
+
+        void setSampleRate( float sampleRate );
+        void setAttack( float milliseconds );
+        void setRelease( float milliseconds );
+
+        // clears the envelope (e.g. when the processor is (re)activated)
+
+        void reset();
+
+        // analyses bufferSize samples of given channels (starting at offset), returns the envelope at the end of the
+        // range (in 0 - 1 range). When amountOfChannels is 0 (e.g. the side chain isn't connected), the envelope is released
+
+        template <typename SampleType>
+        float process( SampleType** channels, int amountOfChannels, int bufferSize, int offset = 0 );
+
+        float getEnvelope();
+
+        // the amount of samples remaining until the envelope is next updated
+
+        int getSamplesUntilTick();
+
+    private:
+        float _sampleRate  = 44100.f;
+        float _attackTime  = 5.f;   // in milliseconds
+        float _releaseTime = 150.f; // in milliseconds
+        float _attack      = 0.f;   // coefficients per control rate tick
+        float _release     = 0.f;
+
+        float _envelope = 0.f;
+        float _peak     = 0.f; // peak of the current control period
+        int _position   = 0;   // position within the current control period
+
+        void cacheCoefficients();
+        void tick();
+};
+}
+
+#include "envelopefollower.tcc"
+
+#endif
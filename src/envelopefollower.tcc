@@ -0,0 +1,57 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+template <typename SampleType>
+float EnvelopeFollower::process( SampleType** channels, int amountOfChannels, int bufferSize, int offset )
+{
+    int end = offset + bufferSize;
+
+    while ( offset < end ) {
+        // inspect the samples up until the next control rate tick
+
+        int length = std::min( end - offset, getSamplesUntilTick() );
+
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            const SampleType* channel = channels[ c ] + offset;
+            SampleType peak = 0;
+
+            for ( int i = 0; i < length; ++i ) {
+                peak = std::max( peak, std::abs( channel[ i ]));
+            }
+            _peak = std::max( _peak, std::min( 1.f, ( float ) peak ));
+        }
+        offset    += length;
+        _position += length;
+
+        if ( _position == CONTROL_RATE ) {
+            tick();
+        }
+    }
+    return _envelope;
+}
+
+}
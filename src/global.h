@@ -12,6 +12,7 @@ namespace VST {
 
     static const int   ID       = 97151820;
     static const char* NAME     = "Homecorrupter";
+    static const char* NAME_SC  = "Homecorrupter SideChain"; // variant with a side chain input
     static const char* VENDOR   = "igorski.nl";
 
     // generate unique UIDs for these (www.uuidgenerator.net is great for this)
@@ -22,6 +23,13 @@ namespace VST {
 
     extern float SAMPLE_RATE; // set upon initialization, see vst.cpp
 
+    // changes to the parameters affecting the latency are sent directly from the controller to the processor, as
+    // the processor must have applied these by the time the host queries the new latency (see PluginController::setParamNormalized())
+
+    static const char* LATENCY_PARAMETER_MESSAGE = "LatencyParameter";
+    static const char* LATENCY_PARAMETER_ID      = "Id";
+    static const char* LATENCY_PARAMETER_VALUE   = "Value";
+
     static const float PI       = 3.141592653589793f;
     static const float TWO_PI   = PI * 2.f;
     static const float SQRT_TWO = sqrt( 2 );
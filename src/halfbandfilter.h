@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __HALFBANDFILTER_H_INCLUDED__
+#define __HALFBANDFILTER_H_INCLUDED__
+
+#include <vector>
+
+namespace Igorski {
+/**
+ * A HalfBandFilter is a linear phase FIR lowpass filter with its cutoff at a quarter
+ * of the sampling rate, used to double or halve the sampling rate of a signal.
+ *
+ * As every other coefficient of a half band filter is zero (except for the center tap)
+ * the filter is split into two polyphase branches: a single delay (the center tap) and
+ * a short FIR filter running at the lower sampling rate, meaning that only a quarter of
+ * the taps are evaluated per sample at the higher sampling rate.
+ *
+ * The branch is calculated per coefficient over the full buffer (rather than per sample
+ * over all coefficients), allowing the compiler to vectorize the inner loop.
+ *
+ * An instance holds the history of a single signal, and should be used for a single direction.
+ * SampleType describes the precision of the signal (e.g. float or double).
+ */
+template <typename SampleType>
+class HalfBandFilter
+{
+    public:
+        // amount of (non-zero) coefficients in the FIR branch
+        static constexpr int BRANCH_SIZE = 24;
+
+        // the delay (in samples at the higher sampling rate) of a single pass
+        static constexpr int DELAY = BRANCH_SIZE - 1;
+
+        HalfBandFilter();
+        ~HalfBandFilter();
+
+        // writes bufferSize * 2 samples into given out buffer
+
+        void upsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize );
+
+        // reads bufferSize * 2 samples from given in buffer, writing bufferSize samples into out buffer
+
+        void downsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize );
+
+        void reset();
+
+    private:
+        static constexpr int HISTORY_SIZE = BRANCH_SIZE - 1;
+        static constexpr int CENTER_DELAY = BRANCH_SIZE / 2; // delay of the center tap (relative to the branch)
+
+        SampleType _coefficients[ BRANCH_SIZE ];
+
+        std::vector<SampleType> _branchInput;  // history followed by the input of the current buffer
+        std::vector<SampleType> _centerInput;  // history followed by the input of the current buffer (downsampling only)
+        std::vector<SampleType> _branchOutput;
+
+        void calculateCoefficients();
+        void prepare( int bufferSize );
+};
+}
+
+#include "halfbandfilter.tcc"
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+template <typename SampleType>
+HalfBandFilter<SampleType>::HalfBandFilter()
+{
+    calculateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+HalfBandFilter<SampleType>::~HalfBandFilter()
+{
+
+}
+
+/* public methods */
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::upsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize )
+{
+    prepare( bufferSize );
+
+    SampleType* input  = _branchInput.data() + HISTORY_SIZE;
+    SampleType* output = _branchOutput.data();
+
+    std::copy( inBuffer, inBuffer + bufferSize, input );
+    std::fill( output, output + bufferSize, ( SampleType ) 0 );
+
+    // the even output samples are provided by the FIR branch (doubled in gain to compensate for the
+    // energy lost by inserting zeroes) while the odd output samples are the delayed input (center tap)
+
+    for ( int i = 0; i < BRANCH_SIZE; ++i ) {
+        const SampleType coefficient = 2 * _coefficients[ i ];
+        const SampleType* x = input - i;
+        for ( int n = 0; n < bufferSize; ++n ) {
+            output[ n ] += coefficient * x[ n ];
+        }
+    }
+
+    const SampleType* delayed = input - ( CENTER_DELAY - 1 );
+
+    for ( int n = 0; n < bufferSize; ++n ) {
+        outBuffer[ n * 2 ]     = output[ n ];
+        outBuffer[ n * 2 + 1 ] = delayed[ n ];
+    }
+
+    // keep the most recent input as the history for the next buffer
+
+    std::copy( input + bufferSize - HISTORY_SIZE, input + bufferSize, _branchInput.data() );
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::downsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize )
+{
+    prepare( bufferSize );
+
+    SampleType* branchInput = _branchInput.data() + HISTORY_SIZE;
+    SampleType* centerInput = _centerInput.data() + CENTER_DELAY;
+
+    // split the input into its polyphase components
+
+    for ( int n = 0; n < bufferSize; ++n ) {
+        branchInput[ n ] = inBuffer[ n * 2 ];
+        centerInput[ n ] = inBuffer[ n * 2 + 1 ];
+    }
+
+    const SampleType* delayed = centerInput - CENTER_DELAY;
+
+    for ( int n = 0; n < bufferSize; ++n ) {
+        outBuffer[ n ] = ( SampleType ) .5 * delayed[ n ];
+    }
+
+    for ( int i = 0; i < BRANCH_SIZE; ++i ) {
+        const SampleType coefficient = _coefficients[ i ];
+        const SampleType* x = branchInput - i;
+        for ( int n = 0; n < bufferSize; ++n ) {
+            outBuffer[ n ] += coefficient * x[ n ];
+        }
+    }
+
+    // keep the most recent input as the history for the next buffer
+
+    std::copy( branchInput + bufferSize - HISTORY_SIZE, branchInput + bufferSize, _branchInput.data() );
+    std::copy( centerInput + bufferSize - CENTER_DELAY, centerInput + bufferSize, _centerInput.data() );
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::reset()
+{
+    std::fill( _branchInput.begin(), _branchInput.end(), ( SampleType ) 0 );
+    std::fill( _centerInput.begin(), _centerInput.end(), ( SampleType ) 0 );
+}
+
+/* private methods */
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::calculateCoefficients()
+{
+    // Kaiser windowed sinc. The full kernel has BRANCH_SIZE * 2 - 1 taps, of which only
+    // the center tap (.5) and the odd taps relative to it (the branch) are non-zero
+
+    const double PI   = 3.141592653589793;
+    const double BETA = 8.0;
+
+    auto bessel = []( double x ) {
+        // zeroth order modified Bessel function of the first kind (series expansion)
+        double sum  = 1.0;
+        double term = 1.0;
+        for ( int k = 1; k < 32; ++k ) {
+            term *= ( x / ( 2.0 * k )) * ( x / ( 2.0 * k ));
+            sum  += term;
+        }
+        return sum;
+    };
+
+    double center = ( double ) ( BRANCH_SIZE - 1 );
+    double sum    = 0.0;
+    double coefficients[ BRANCH_SIZE ];
+
+    for ( int i = 0; i < BRANCH_SIZE; ++i ) {
+        double offset = ( double ) ( i * 2 ) - center; // always odd
+        double sinc   = sin( PI * offset * .5 ) / ( PI * offset );
+        double ratio  = offset / center;
+        double window = bessel( BETA * sqrt( 1.0 - ratio * ratio )) / bessel( BETA );
+
+        coefficients[ i ] = sinc * window;
+        sum += coefficients[ i ];
+    }
+
+    // normalize for unity gain at DC (where the center tap provides the other half)
+
+    for ( int i = 0; i < BRANCH_SIZE; ++i ) {
+        _coefficients[ i ] = ( SampleType ) ( coefficients[ i ] * .5 / sum );
+    }
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::prepare( int bufferSize )
+{
+    // buffers only grow (e.g. this only allocates on the first process cycle or when the buffer size increases)
+
+    if (( int ) _branchOutput.size() >= bufferSize ) {
+        return;
+    }
+    _branchInput.resize( HISTORY_SIZE + bufferSize, ( SampleType ) 0 );
+    _centerInput.resize( CENTER_DELAY + bufferSize, ( SampleType ) 0 );
+    _branchOutput.resize( bufferSize, ( SampleType ) 0 );
+}
+
+}
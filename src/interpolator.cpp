@@ -0,0 +1,141 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "interpolator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+Interpolator::Interpolator()
+{
+    createSincTable();
+}
+
+Interpolator::~Interpolator()
+{
+
+}
+
+/* public methods */
+
+void Interpolator::setQuality( Quality quality )
+{
+    _quality = quality;
+
+    switch ( quality ) {
+        default:
+        case HOLD:
+            _amountOfTaps = 1;
+            _firstTap     = 0;
+            break;
+        case LINEAR:
+            _amountOfTaps = 2;
+            _firstTap     = 0;
+            break;
+        case HERMITE:
+            _amountOfTaps = 4;
+            _firstTap     = -1;
+            break;
+        case SINC:
+            _amountOfTaps = MAX_TAPS;
+            _firstTap     = -( MAX_TAPS / 2 - 1 );
+            break;
+    }
+}
+
+Interpolator::Quality Interpolator::getQuality()
+{
+    return _quality;
+}
+
+int Interpolator::getAmountOfTaps()
+{
+    return _amountOfTaps;
+}
+
+void Interpolator::prepare( int amountOfPositions, int bufferSize, int newestIndex )
+{
+    reserve( amountOfPositions );
+
+    _amountOfPositions = amountOfPositions;
+    _bufferSize        = std::max( 1, bufferSize );
+    _newestIndex       = newestIndex;
+}
+
+void Interpolator::reserve( int amountOfPositions )
+{
+    // the tap arrays only grow (e.g. this only allocates on the first process cycle or when the buffer size increases)
+
+    if ( amountOfPositions > _capacity ) {
+        _capacity = amountOfPositions;
+        _indices.assign( _capacity * MAX_TAPS, 0 );
+        _weights.assign( _capacity * MAX_TAPS, 0.f );
+    }
+}
+
+/* private methods */
+
+void Interpolator::createSincTable()
+{
+    const double PI = 3.141592653589793;
+    const double HALF_WIDTH = MAX_TAPS / 2;
+
+    _sincTable.resize(( SINC_PHASES + 1 ) * MAX_TAPS );
+
+    for ( int phase = 0; phase <= SINC_PHASES; ++phase ) {
+        double fraction = ( double ) phase / SINC_PHASES;
+        double sum      = 0.0;
+        double weights[ MAX_TAPS ];
+
+        for ( int tap = 0; tap < MAX_TAPS; ++tap ) {
+            // distance between the tap and the read position
+
+            double x    = ( double ) ( tap - ( MAX_TAPS / 2 - 1 )) - fraction;
+            double sinc = sin( PI * x ) / ( PI * x );
+
+            // at integer distances the kernel should read the sample as-is
+
+            if ( phase == 0 || phase == SINC_PHASES ) {
+                sinc = std::abs( x ) < 1e-9 ? 1.0 : 0.0;
+            }
+
+            // Blackman window spanning the kernel
+
+            double position = ( x + HALF_WIDTH ) / ( 2.0 * HALF_WIDTH );
+            double window   = 0.42 - 0.5 * cos( 2.0 * PI * position ) + 0.08 * cos( 4.0 * PI * position );
+
+            weights[ tap ] = sinc * window;
+            sum += weights[ tap ];
+        }
+
+        // normalize for unity gain at DC
+
+        for ( int tap = 0; tap < MAX_TAPS; ++tap ) {
+            _sincTable[ phase * MAX_TAPS + tap ] = ( float ) ( weights[ tap ] / sum );
+        }
+    }
+}
+
+}
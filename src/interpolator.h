@@ -0,0 +1,165 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __INTERPOLATOR_H_INCLUDED__
+#define __INTERPOLATOR_H_INCLUDED__
+
+#include <vector>
+
+namespace Igorski {
+/**
+ * An Interpolator reads samples at fractional positions of a (circular) buffer.
+ *
+ * As the read positions are equal for all channels, the read indices and interpolation
+ * weights for all positions are calculated once (see prepare() and setPosition()) after
+ * which the samples of each channel are gathered and weighted in a single pass per tap
+ * (see apply()) which the compiler can vectorize.
+ *
+ * Taps that lie beyond the most recently written sample of the buffer are clamped
+ * to that sample (as the subsequent samples have yet to be written).
+ */
+class Interpolator
+{
+    public:
+        enum Quality {
+            HOLD = 0, // no interpolation (reads the sample at the integer position)
+            LINEAR,   // 2 taps
+            HERMITE,  // 4 point, 3rd order Hermite (Catmull-Rom)
+            SINC      // 8 point windowed sinc
+        };
+
+        static constexpr int MAX_TAPS    = 8;
+        static constexpr int SINC_PHASES = 1024; // resolution of the fractional position for the sinc kernel
+
+        Interpolator();
+        ~Interpolator();
+
+        void setQuality( Quality quality );
+        Quality getQuality();
+
+        int getAmountOfTaps();
+
+        /**
+         * prepares the interpolator for reading given amountOfPositions from a
+         * circular buffer of given bufferSize where newestIndex is the index
+         * of the most recently written sample
+         */
+        void prepare( int amountOfPositions, int bufferSize, int newestIndex );
+
+        // allocates the taps for given amountOfPositions up front (e.g. while sizing the other buffers)
+
+        void reserve( int amountOfPositions );
+
+        // updates the index of the most recently written sample (applies to subsequent setPosition() invocations)
+
+        inline void setNewestIndex( int newestIndex ) {
+            _newestIndex = newestIndex;
+        }
+
+        // calculates the read indices and weights for the position at given index
+
+        inline void setPosition( int index, int position, float fraction ) {
+            if ( position >= _bufferSize ) {
+                position %= _bufferSize;
+            }
+
+            // amount of samples available beyond the read position
+
+            int ahead = _newestIndex - position;
+            if ( ahead < 0 ) {
+                ahead += _bufferSize;
+            }
+
+            float* weights = _weights.data() + index;
+            int* indices   = _indices.data() + index;
+
+            for ( int tap = 0, offset = _firstTap; tap < _amountOfTaps; ++tap, ++offset ) {
+                int readIndex = position + ( offset > ahead ? ahead : offset );
+
+                if ( readIndex < 0 ) {
+                    readIndex += _bufferSize;
+                } else if ( readIndex >= _bufferSize ) {
+                    readIndex -= _bufferSize;
+                }
+                indices[ tap * _capacity ] = readIndex;
+            }
+
+            float t = fraction;
+
+            switch ( _quality ) {
+                default:
+                case HOLD:
+                    weights[ 0 ] = 1.f;
+                    break;
+
+                case LINEAR:
+                    weights[ 0 ]         = 1.f - t;
+                    weights[ _capacity ] = t;
+                    break;
+
+                case HERMITE:
+                    weights[ 0 ]             = t * (( 2.f - t ) * t - 1.f ) * .5f;
+                    weights[ _capacity ]     = ( t * t * ( 3.f * t - 5.f ) + 2.f ) * .5f;
+                    weights[ _capacity * 2 ] = t * (( 4.f - 3.f * t ) * t + 1.f ) * .5f;
+                    weights[ _capacity * 3 ] = ( t - 1.f ) * t * t * .5f;
+                    break;
+
+                case SINC: {
+                    const float* kernel = &_sincTable[( int )( t * SINC_PHASES + .5f ) * MAX_TAPS ];
+                    for ( int tap = 0; tap < MAX_TAPS; ++tap ) {
+                        weights[ tap * _capacity ] = kernel[ tap ];
+                    }
+                    break;
+                }
+            }
+        }
+
+        // interpolates the samples at the prepared positions of given buffer, writing
+        // the results into given output (which should hold the prepared amount of positions)
+
+        template <typename SampleType>
+        void apply( const SampleType* buffer, SampleType* output );
+
+    private:
+        Quality _quality = HOLD;
+        int _amountOfTaps = 1;
+        int _firstTap     = 0; // offset of the first tap relative to the read position
+
+        int _amountOfPositions = 0;
+        int _capacity          = 0; // the maximum amount of positions the tap arrays can hold
+        int _bufferSize        = 1;
+        int _newestIndex       = 0;
+
+        // indices and weights of all positions, per tap (e.g. tap * _capacity + position)
+
+        std::vector<int>   _indices;
+        std::vector<float> _weights;
+
+        std::vector<float> _sincTable; // weights for each of the ( SINC_PHASES + 1 ) fractional positions
+
+        void createSincTable();
+};
+}
+
+#include "interpolator.tcc"
+
+#endif
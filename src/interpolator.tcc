@@ -0,0 +1,51 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+// the restrict qualifiers guarantee the compiler that the gathered buffer is not written to
+// (which cannot be verified at runtime for indexed reads), allowing it to vectorize the gather
+
+template <typename SampleType>
+static inline void accumulateTap( SampleType* __restrict output, const float* __restrict weights,
+                                  const SampleType* __restrict buffer, const int* __restrict indices, int amount )
+{
+    for ( int i = 0; i < amount; ++i ) {
+        output[ i ] += weights[ i ] * buffer[ indices[ i ]];
+    }
+}
+
+template <typename SampleType>
+void Interpolator::apply( const SampleType* buffer, SampleType* output )
+{
+    int amount = _amountOfPositions;
+
+    std::fill( output, output + amount, ( SampleType ) 0 );
+
+    for ( int tap = 0; tap < _amountOfTaps; ++tap ) {
+        accumulateTap( output, _weights.data() + tap * _capacity, buffer, _indices.data() + tap * _capacity, amount );
+    }
+}
+
+}
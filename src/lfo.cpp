@@ -21,12 +21,17 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "lfo.h"
+#include <math.h>
 
 namespace Igorski {
 
+// the cycle length (in quarter notes) of each note division, from 4 bars to a 32nd note
+
+static const double DIVISIONS[ LFO::AMOUNT_OF_DIVISIONS ] = { 16.0, 8.0, 4.0, 2.0, 1.0, .5, .25, .125 };
+
 LFO::LFO() {
-    _rate        = VST::MIN_LFO_RATE();
-    _accumulator = 0.f;
+    _rate  = VST::MIN_LFO_RATE();
+    _phase = 0;
 }
 
 LFO::~LFO() {
@@ -45,14 +50,85 @@ void LFO::setRate( float value )
     _rate = value;
 }
 
-void LFO::setAccumulator( float value )
+void LFO::setTempoSync( bool enabled )
+{
+    _tempoSync = enabled;
+}
+
+bool LFO::isTempoSynced()
+{
+    return _tempoSync;
+}
+
+void LFO::setSyncedRate( float value )
+{
+    int index = ( int ) ( value * AMOUNT_OF_DIVISIONS );
+    _cycleLength = DIVISIONS[ index < 0 ? 0 : ( index >= AMOUNT_OF_DIVISIONS ? AMOUNT_OF_DIVISIONS - 1 : index )];
+}
+
+double LFO::getCycleLength()
+{
+    return _cycleLength;
+}
+
+void LFO::setTempo( double tempo )
 {
-    _accumulator = value;
+    if ( tempo > 0.0 ) {
+        _tempo = tempo;
+    }
 }
 
-float LFO::getAccumulator()
+void LFO::syncToPosition( double projectTimeMusic )
 {
-    return _accumulator;
+    setNormalizedPhase( projectTimeMusic / _cycleLength );
+}
+
+float LFO::getPhase()
+{
+    return ( float ) (( double ) _phase / 18446744073709551616.0 );
+}
+
+void LFO::setPhase( float value )
+{
+    setNormalizedPhase(( double ) value );
+}
+
+void LFO::setInterpolated( bool interpolated )
+{
+    _interpolated = interpolated;
+}
+
+bool LFO::isInterpolated()
+{
+    return _interpolated;
+}
+
+void LFO::render( float* buffer, int bufferSize )
+{
+    uint64_t phase     = _phase;
+    uint64_t increment = getPhaseIncrement();
+
+    if ( _interpolated ) {
+        for ( int i = 0; i < bufferSize; ++i, phase += increment ) {
+            buffer[ i ] = read( toPhase( phase ));
+        }
+    } else {
+        for ( int i = 0; i < bufferSize; ++i, phase += increment ) {
+            buffer[ i ] = VST::TABLE[ toPhase( phase ) >> FRACTION_BITS ];
+        }
+    }
+    _phase = phase;
+}
+
+/* private methods */
+
+void LFO::setNormalizedPhase( double value )
+{
+    // only the fractional part of the value describes the position within the cycle
+    // (note that for tiny negative values, the fractional part can round up to 1)
+
+    double phase = value - floor( value );
+    _phase = phase >= 1.0 ? 0 : ( uint64_t ) ( phase * 18446744073709551616.0 );
 }
 
 }
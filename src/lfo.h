@@ -24,8 +24,26 @@
 #define __LFO_H_INCLUDED__
 
 #include "global.h"
+#include <cstdint>
 
 namespace Igorski {
+/**
+ * The LFO reads the wave table (see VST::TABLE) using a 32-bit fixed point phase, where
+ * the full range of the integer describes a single cycle. This allows the phase to wrap
+ * by overflowing (without branching) while the upper bits provide the table index and the
+ * lower bits the fractional position between two table entries.
+ *
+ * The phase is accumulated at 64-bit precision and rounded to 32 bits when read, so the
+ * error of the (rounded) increment does not accumulate into a different table entry.
+ * Otherwise a phase calculated directly (see syncToPosition()) and an accumulated phase
+ * would disagree whenever a sample lands exactly on a table entry (e.g. on the beat).
+ *
+ * As the oscillators values are shared by all channels, these are rendered for a
+ * whole block at once (see render()) rather than calculated per sample per channel.
+ *
+ * When synchronized to the host tempo, the rate is expressed as a note division and the
+ * phase is derived from the hosts musical position (see syncToPosition()).
+ */
 class LFO {
 
     public:
@@ -33,45 +51,107 @@ class LFO {
         ~LFO();
 
         float getRate();
-        void setRate( float value );
+        void setRate( float value ); // in Hz
+
+        // tempo synchronization
+
+        static constexpr int AMOUNT_OF_DIVISIONS = 8;
+
+        void setTempoSync( bool enabled );
+        bool isTempoSynced();
+
+        // selects the note division used when synchronized (0 - 1 range, slowest to fastest)
 
-        // accumulators are used to retrieve a sample from the wave table
-        // in other words: track the progress of the oscillator against its range
+        void setSyncedRate( float value );
+        double getCycleLength(); // in quarter notes
 
-        float getAccumulator();
-        void setAccumulator( float offset );
+        void setTempo( double tempo ); // in beats per minute
 
         /**
-         * retrieve a value from the wave table for the current
-         * accumulator position, this method also increments
-         * the accumulator and keeps it within bounds
+         * sets the phase for given position in the host's timeline (in quarter notes). As
+         * the phase is calculated directly from the position (rather than accumulated) it
+         * does not drift and jumping to another position does not require catching up
          */
-        inline float peek()
-        {
-            // the wave table offset to read from
-            float SR_OVER_LENGTH = VST::SAMPLE_RATE / ( float ) TABLE_SIZE;
-            int readOffset = ( _accumulator == 0.f ) ? 0 : ( int ) ( _accumulator / SR_OVER_LENGTH );
+        void syncToPosition( double projectTimeMusic );
+
+        // the phase describes the progress of the oscillator within its cycle (0 - 1 range)
 
-            // increment the accumulators read offset
-            _accumulator += _rate;
+        float getPhase();
+        void setPhase( float value );
 
-            // keep the accumulator within the bounds of the sample frequency
-            if ( _accumulator > VST::SAMPLE_RATE )
-                _accumulator -= VST::SAMPLE_RATE;
+        // when enabled, the values in between the wave table entries are linearly
+        // interpolated, otherwise the value of the preceding entry is held (default)
 
-            // return the sample present at the calculated offset within the table
-            return VST::TABLE[ readOffset ];
+        void setInterpolated( bool interpolated );
+        bool isInterpolated();
+
+        /**
+         * render the oscillators value for given bufferSize amount of
+         * samples into given buffer, advancing the phase accordingly
+         */
+        void render( float* buffer, int bufferSize );
+
+        /**
+         * retrieve a single value from the wave table for the current
+         * phase, this method also advances the phase by a single sample
+         */
+        inline float peek()
+        {
+            float value = read( toPhase( _phase ));
+            _phase += getPhaseIncrement();
+            return value;
         }
 
     private:
 
         // see Igorski::VST::LFO_TABLE;
-        static const int TABLE_SIZE = 128;
+        static constexpr int TABLE_SIZE = 128;
+
+        // the amount of bits of the phase used for the fractional position within the table
+        // (the remaining upper bits provide the table index)
 
-        // used internally
+        static constexpr int FRACTION_BITS = 25;
+        static constexpr uint32_t FRACTION_MASK = ( 1u << FRACTION_BITS ) - 1;
 
         float _rate;
-        float _accumulator;   // is read offset in wave table buffer
+        uint64_t _phase = 0; // see class description
+        bool _interpolated = false;
+
+        bool _tempoSync = false;
+        double _tempo = 120.0;
+        double _cycleLength = 4.0; // length of a single cycle in quarter notes (when synchronized)
+
+        // the phase increment per sample for the current rate and sample rate. The sample rate
+        // can change in between process cycles, as such this is calculated when rendering
+
+        inline uint64_t getPhaseIncrement()
+        {
+            double rate = _tempoSync ? _tempo / 60.0 / _cycleLength : ( double ) _rate;
+            return ( uint64_t ) ( rate / ( double ) VST::SAMPLE_RATE * 18446744073709551616.0 + .5 );
+        }
+
+        // rounds the accumulated phase to the 32-bit phase used to read the table
+
+        static inline uint32_t toPhase( uint64_t phase )
+        {
+            return ( uint32_t ) (( phase + ( 1ull << 31 )) >> 32 );
+        }
+
+        void setNormalizedPhase( double value );
+
+        inline float read( uint32_t phase )
+        {
+            int index = ( int ) ( phase >> FRACTION_BITS );
+
+            if ( !_interpolated ) {
+                return VST::TABLE[ index ];
+            }
+            float fraction = ( float ) ( phase & FRACTION_MASK ) * ( 1.f / ( float ) ( FRACTION_MASK + 1 ));
+            float current  = VST::TABLE[ index ];
+            float next     = VST::TABLE[( index + 1 ) & ( TABLE_SIZE - 1 )];
+
+            return current + ( next - current ) * fraction;
+        }
 };
 }
 
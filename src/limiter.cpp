@@ -57,21 +57,25 @@ Limiter::~Limiter()
 void Limiter::setAttack( float attackNormalized )
 {
     _attack = pow( 10.0, -2.0 * attackNormalized );
+    cacheEnvelope();
 }
 
 void Limiter::setAttackMicroseconds( float attackInMicroseconds )
 {
     _attack = 1.0 - Igorski::Calc::inverseLog( 1.f / ( attackInMicroseconds / -301030.1f ) / ( float ) Igorski::VST::SAMPLE_RATE, 10 );
+    cacheEnvelope();
 }
 
 void Limiter::setRelease( float releaseNormalized )
 {
     _release = pow( 10.0, -2.0 - ( 3.0 * releaseNormalized ));
+    cacheEnvelope();
 }
 
 void Limiter::setReleaseMilliseconds( float releaseInMilliseconds )
 {
     _release = 1.0 - Igorski::Calc::inverseLog( 1.f / ( releaseInMilliseconds / -301.0301f ) / ( float ) Igorski::VST::SAMPLE_RATE, 10 );
+    cacheEnvelope();
 }
 
 void Limiter::setThreshold( float thresholdNormalized )
@@ -91,9 +95,61 @@ void Limiter::setSoftKnee( bool softKnee )
     cacheValues();
 }
 
+void Limiter::setLookahead( float lookaheadInMilliseconds )
+{
+    _lookaheadMs = lookaheadInMilliseconds;
+
+    int lookahead = std::max( 0, Igorski::Calc::millisecondsToBuffer( lookaheadInMilliseconds )) * _oversampling;
+
+    if ( lookahead == _lookahead ) {
+        return;
+    }
+    _lookahead = lookahead;
+
+    prepareLookahead();
+}
+
+void Limiter::setAmountOfChannels( int amountOfChannels )
+{
+    if ( amountOfChannels == _lookaheadChannels ) {
+        return;
+    }
+    _lookaheadChannels = amountOfChannels;
+
+    prepareLookahead();
+}
+
+int Limiter::getLatency()
+{
+    return _lookahead / _oversampling;
+}
+
+void Limiter::setOversampling( int factor )
+{
+    factor = std::max( 1, factor );
+
+    if ( factor == _oversampling ) {
+        return;
+    }
+    _oversampling = factor;
+
+    cacheEnvelope();
+    setLookahead( _lookaheadMs );
+}
+
 float Limiter::getLinearGR()
 {
-    return ( _gain > 1.0f ) ? 1.0f / ( float ) _gain : 1.0f;
+    return _minGain;
+}
+
+float Limiter::getPeak()
+{
+    return _peak;
+}
+
+float Limiter::getRms()
+{
+    return _rms;
 }
 
 /* protected methods */
@@ -112,6 +168,17 @@ void Limiter::init( float attackNormalized, float releaseNormalized, float thres
     setSoftKnee( softKnee );
 }
 
+void Limiter::prepareLookahead()
+{
+    _lookaheadIndex = 0;
+    _lookaheadBuffer.assign( _lookaheadChannels * _lookahead, 0.0 );
+
+    _windowValues.assign( _lookahead + 1, 0.0 );
+    _windowPositions.assign( _lookahead + 1, 0 );
+    _windowHead = 0;
+    _windowSize = 0;
+}
+
 void Limiter::cacheValues()
 {
     if ( _softKnee ) {
@@ -120,3 +187,18 @@ void Limiter::cacheValues()
         pThreshold = pow( 10.0, ( 2.0 * _threshold ) - 2.0 );
     }
 }
+
+void Limiter::cacheEnvelope()
+{
+    if ( _oversampling == 1 ) {
+        pAttack  = _attack;
+        pRelease = _release;
+        return;
+    }
+
+    // the envelope moves by the coefficient each sample, when oversampling the
+    // coefficients are scaled so the same distance is covered over factor times the amount of samples
+
+    pAttack  = 1.0 - pow( 1.0 - _attack,  1.0 / _oversampling );
+    pRelease = 1.0 - pow( 1.0 - _release, 1.0 / _oversampling );
+}
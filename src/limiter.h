@@ -27,7 +27,11 @@
 #define __LIMITER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "calc.h"
+#include <algorithm>
+#include <cmath>
 #include <math.h>
+#include <vector>
 
 class Limiter
 {
@@ -50,6 +54,11 @@ class Limiter
         Limiter( float attackNormalized, float releaseNormalized, float thresholdNormalized );
         ~Limiter();
 
+        /**
+         * apply the limiter onto given outputBuffer, all numOutChannels
+         * are linked to a single detector (summing a stereo pair, following
+         * the loudest channel for wider layouts)
+         */
         template <typename SampleType>
         void process( SampleType** outputBuffer, int bufferSize, int numOutChannels );
 
@@ -61,11 +70,45 @@ class Limiter
         bool getSoftKnee();
         void setSoftKnee( bool softKnee );
 
-        float getLinearGR();
+        /**
+         * lookahead delays the output by given amount of milliseconds (calculated
+         * for the current sample rate) allowing the gain to reach its target before
+         * a peak arrives at the output. 0 disables the lookahead (zero latency mode)
+         * This allocates the delay lines (not during processing!)
+         */
+        void setLookahead( float lookaheadInMilliseconds );
+        int getLatency(); // in samples
+
+        // the amount of channels the lookahead delay lines are allocated for (not during processing!)
+
+        void setAmountOfChannels( int amountOfChannels );
+
+        /**
+         * when the provided buffers are oversampled by given factor, the envelope and
+         * lookahead are scaled accordingly so the limiter behaves identically to processing
+         * at the original sample rate (latency remains expressed at the original sample rate)
+         */
+        void setOversampling( int factor );
+
+        // metering of the last processed buffer (measured over all channels while applying the gain,
+        // when oversampling these are measured at the oversampled rate)
+
+        float getLinearGR(); // lowest gain applied by the envelope (1 == no gain reduction)
+        float getPeak();     // peak output level
+        float getRms();      // RMS output level
 
     protected:
+        // amount of samples analysed at once by the detector
+
+        static constexpr int DETECTOR_SIZE = 64;
+
+        // amount of partial results the output meters are reduced in (allowing the compiler to vectorize the reduction)
+
+        static constexpr int METER_LANES = 8;
+
         void init( float attackNormalized, float releaseNormalized, float thresholdNormalized, bool softKnee );
         void cacheValues();
+        void cacheEnvelope();
 
         // instance variables
 
@@ -73,9 +116,37 @@ class Limiter
         float _trim;
         float _attack;
         float _release;
-        float _gain;
+        double _gain; // kept at double precision for hosts processing in double precision
         bool  _softKnee;
         float pThreshold; // cached process value of threshold for given knee type
+        float pAttack;    // cached process values of attack and release for the oversampling factor
+        float pRelease;
+        int _oversampling = 1;
+
+        // metering
+
+        float _minGain = 1.f;
+        float _peak    = 0.f;
+        float _rms     = 0.f;
+
+        // lookahead
+
+        int _lookahead = 0;         // in samples, 0 == no lookahead
+        float _lookaheadMs = 0.f;
+        int _lookaheadChannels = 0; // amount of channels the delay lines are allocated for
+        int _lookaheadIndex = 0;    // write index within the delay lines
+        std::vector<double> _lookaheadBuffer; // all channel delay lines (sequentially, _lookahead samples each)
+
+        // monotonic deque providing the maximum detector value within the lookahead window
+        // as a ring buffer of ( _lookahead + 1 ) entries, values are in descending order
+
+        std::vector<double>   _windowValues;
+        std::vector<uint32_t> _windowPositions;
+        int _windowHead = 0;
+        int _windowSize = 0;
+        uint32_t _windowPosition = 0;
+
+        void prepareLookahead();
 };
 
 #include "limiter.tcc"
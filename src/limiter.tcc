@@ -32,59 +32,216 @@ void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChan
 //        return;
 //    }
 
-    SampleType gain, level, leftSample, rightSample;
+    if ( numOutChannels <= 0 ) {
+        return;
+    }
+
+    // all channels are linked to the same detector, where the detector follows the loudest channel.
+    // the buffer is processed in segments of DETECTOR_SIZE samples, where each stage below runs
+    // as a separate loop over contiguous memory so the compiler can vectorize all but the (inherently
+    // sequential) gain envelope. The segment arrays are small enough to live on the stack
+
+    // the delay lines are allocated up front (see setAmountOfChannels()) as this is the process
+    // thread. Should the host provide more channels than these were allocated for, the lookahead is skipped
+
+    bool hasLookahead = _lookahead > 0 && numOutChannels <= _lookaheadChannels;
+
+    // mono and stereo signals use the original detector, which sums the left and right channel (e.g. |L + R|).
+    // Wider layouts are linked to the loudest channel, for correlated channels the sum equals twice the peak,
+    // the threshold is scaled accordingly so these are limited as they would be by the original detector
 
-    gain = _gain;
+    bool sumChannels = numOutChannels <= 2;
+    SampleType threshold = _softKnee ? ( SampleType ) ( pThreshold * ( sumChannels ? 1 : 2 )) : ( SampleType ) ( pThreshold * ( sumChannels ? 2 : 1 ));
 
-    bool hasRight = ( numOutChannels > 1 );
+    SampleType peaks[ DETECTOR_SIZE ];
+    SampleType gains[ DETECTOR_SIZE ];
 
-    SampleType* leftBuffer  = outputBuffer[ 0 ];
-    SampleType* rightBuffer = hasRight ? outputBuffer[ 1 ] : 0;
+    SampleType gain      = ( SampleType ) _gain;
+    SampleType attack    = ( SampleType ) pAttack;
+    SampleType release   = ( SampleType ) pRelease;
+    SampleType trim      = ( SampleType ) _trim;
+    SampleType minGain   = ( SampleType ) 1;
 
-    if ( _softKnee )
+    // the output meters are reduced while applying the gain (see step 3.)
+
+    SampleType meterPeaks[ METER_LANES ]   = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    SampleType meterSquares[ METER_LANES ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    for ( int offset = 0; offset < bufferSize; offset += DETECTOR_SIZE )
     {
-        for ( int i = 0; i < bufferSize; ++i ) {
+        int length = std::min( DETECTOR_SIZE, bufferSize - offset );
 
-            leftSample  = leftBuffer[ i ];
-            rightSample = hasRight ? rightBuffer[ i ] : 0;
+        // 1. linked detector: absolute sum of the stereo pair or maximum absolute value across all channels
 
-            level = SampleType ( 1.0 / ( 1.0 + pThreshold * fabs( leftSample + rightSample )));
+        SampleType* channelBuffer = outputBuffer[ 0 ] + offset;
 
-            if ( gain > level ) {
-                gain = gain - _attack * ( gain - level );
+        if ( numOutChannels == 2 ) {
+            SampleType* rightBuffer = outputBuffer[ 1 ] + offset;
+            for ( int i = 0; i < length; ++i ) {
+                peaks[ i ] = std::abs( channelBuffer[ i ] + rightBuffer[ i ]);
+            }
+        } else {
+            for ( int i = 0; i < length; ++i ) {
+                peaks[ i ] = std::abs( channelBuffer[ i ]);
             }
-            else {
-                gain = gain + _release * ( level - gain );
+            for ( int c = 1; c < numOutChannels; ++c ) {
+                channelBuffer = outputBuffer[ c ] + offset;
+                for ( int i = 0; i < length; ++i ) {
+                    peaks[ i ] = std::max( peaks[ i ], std::abs( channelBuffer[ i ]));
+                }
             }
+        }
+
+        // 1b. in lookahead mode, the detector provides the maximum value of the lookahead window
+        // (which spans the current delay line output up to the most recent input). The window is
+        // a monotonic deque so each sample requires only a constant (amortized) amount of work
 
-            leftBuffer[ i ] = ( leftSample * _trim * gain );
+        if ( hasLookahead )
+        {
+            int capacity = _lookahead + 1;
 
-            if ( hasRight )
-                rightBuffer[ i ] = ( rightSample * _trim * gain );
+            for ( int i = 0; i < length; ++i, ++_windowPosition ) {
+                double peak = ( double ) peaks[ i ];
+
+                // remove the oldest value when it has moved out of the window
+
+                if ( _windowSize > 0 && ( _windowPosition - _windowPositions[ _windowHead ]) > ( uint32_t ) _lookahead ) {
+                    if ( ++_windowHead == capacity ) {
+                        _windowHead = 0;
+                    }
+                    --_windowSize;
+                }
+
+                // remove all values that can no longer be the maximum
+
+                while ( _windowSize > 0 ) {
+                    int back = _windowHead + _windowSize - 1;
+                    if ( back >= capacity ) {
+                        back -= capacity;
+                    }
+                    if ( _windowValues[ back ] > peak ) {
+                        break;
+                    }
+                    --_windowSize;
+                }
+
+                int tail = _windowHead + _windowSize;
+                if ( tail >= capacity ) {
+                    tail -= capacity;
+                }
+                _windowValues[ tail ]    = peak;
+                _windowPositions[ tail ] = _windowPosition;
+                ++_windowSize;
+
+                peaks[ i ] = ( SampleType ) _windowValues[ _windowHead ];
+            }
         }
-    }
-    else
-    {
-        for ( int i = 0; i < bufferSize; ++i ) {
 
-            leftSample  = leftBuffer[ i ];
-            rightSample = hasRight ? rightBuffer[ i ] : 0;
+        // 2. gain envelope
+
+        if ( _softKnee )
+        {
+            // the knee level does not depend on the envelope and can be calculated upfront
 
-            level = SampleType ( 0.5 * gain * fabs( leftSample + rightSample ));
+            for ( int i = 0; i < length; ++i ) {
+                peaks[ i ] = Igorski::Calc::reciprocal(( SampleType ) 1 + threshold * peaks[ i ]);
+            }
+
+            for ( int i = 0; i < length; ++i ) {
+                SampleType level = peaks[ i ];
+
+                if ( gain > level ) {
+                    gain = gain - attack * ( gain - level );
+                }
+                else {
+                    gain = gain + release * ( level - gain );
+                }
+                gains[ i ] = gain * trim;
+                minGain    = std::min( minGain, gain );
+            }
+        }
+        else
+        {
+            for ( int i = 0; i < length; ++i ) {
+                SampleType level = gain * peaks[ i ];
 
-            if ( level > pThreshold ) {
-                gain = gain - ( _attack * ( level - pThreshold ));
+                if ( level > threshold ) {
+                    gain = gain - ( attack * ( level - threshold ));
+                }
+                else {
+                    // below threshold
+                    gain = gain + release * (( SampleType ) 1 - gain );
+                }
+                gains[ i ] = gain * trim;
+                minGain    = std::min( minGain, gain );
             }
-            else {
-                // below threshold
-                gain = gain + SampleType ( _release * ( 1.0 - gain ));
+        }
+
+        // 3. apply the gain envelope onto all channels
+
+        if ( hasLookahead )
+        {
+            // write the input into the delay lines and apply the gain onto their (delayed) output
+
+            int index = _lookaheadIndex;
+
+            for ( int c = 0; c < numOutChannels; ++c ) {
+                channelBuffer = outputBuffer[ c ] + offset;
+                double* delayLine = &_lookaheadBuffer[ c * _lookahead ];
+                index = _lookaheadIndex;
+
+                for ( int i = 0; i < length; ++i ) {
+                    SampleType delayed = ( SampleType ) delayLine[ index ];
+                    SampleType sample  = delayed * gains[ i ];
+                    delayLine[ index ] = ( double ) channelBuffer[ i ];
+                    channelBuffer[ i ] = sample;
+
+                    meterPeaks[ 0 ]    = std::max( meterPeaks[ 0 ], std::abs( sample ));
+                    meterSquares[ 0 ] += sample * sample;
+
+                    if ( ++index == _lookahead ) {
+                        index = 0;
+                    }
+                }
             }
+            _lookaheadIndex = index;
+        }
+        else
+        {
+            for ( int c = 0; c < numOutChannels; ++c ) {
+                channelBuffer = outputBuffer[ c ] + offset;
+                int i = 0;
+
+                for ( ; i <= length - METER_LANES; i += METER_LANES ) {
+                    for ( int j = 0; j < METER_LANES; ++j ) {
+                        SampleType sample = channelBuffer[ i + j ] * gains[ i + j ];
+                        channelBuffer[ i + j ] = sample;
 
-            leftBuffer[ i ] = ( leftSample * _trim * gain );
+                        meterPeaks[ j ]    = std::max( meterPeaks[ j ], std::abs( sample ));
+                        meterSquares[ j ] += sample * sample;
+                    }
+                }
 
-            if ( hasRight )
-                rightBuffer[ i ] = ( rightSample * _trim * gain );
+                for ( ; i < length; ++i ) {
+                    SampleType sample = channelBuffer[ i ] * gains[ i ];
+                    channelBuffer[ i ] = sample;
+
+                    meterPeaks[ 0 ]    = std::max( meterPeaks[ 0 ], std::abs( sample ));
+                    meterSquares[ 0 ] += sample * sample;
+                }
+            }
         }
     }
-    _gain = gain;
+    _gain = ( double ) gain;
+
+    // combine the partial results of the meters
+
+    SampleType peak = 0, squares = 0;
+    for ( int j = 0; j < METER_LANES; ++j ) {
+        peak     = std::max( peak, meterPeaks[ j ]);
+        squares += meterSquares[ j ];
+    }
+    _minGain = ( float ) minGain;
+    _peak    = ( float ) peak;
+    _rms     = ( float ) sqrt( squares / ( SampleType ) ( bufferSize * numOutChannels ));
 }
@@ -42,6 +42,16 @@ LowPassFilter::~LowPassFilter()
 /* public methods */
 
 void LowPassFilter::setRatio( float frequencyRatio )
+{
+    if ( frequencyRatio == _ratio ) {
+        return; // coefficients are up to date
+    }
+    _ratio = frequencyRatio;
+
+    calculateCoefficients( frequencyRatio, coefficients );
+}
+
+void LowPassFilter::calculateCoefficients( float frequencyRatio, float* coefficients )
 {
     const float proportionalRate = frequencyRatio > 1.0f ? 0.5f / frequencyRatio : 0.5f  * frequencyRatio;
     const float n = 1.f / tan(( float ) VST::PI * std::max( 0.001f, proportionalRate ));
@@ -51,14 +61,14 @@ void LowPassFilter::setRatio( float frequencyRatio )
 
     UNDENORMALISE( c1 );
 
-    setFilterCoefficients(
-        c1,
-        c1 * 2.f,
-        c1,
-        1.f,
-        c1 * 2.f * ( 1.f - nSquared ),
-        c1 * ( 1.f - VST::SQRT_TWO * n + nSquared )
-    );
+    // c4 is always 1.f, meaning the remaining coefficients need not be normalized by it
+
+    coefficients[ 0 ] = c1;
+    coefficients[ 1 ] = c1 * 2.f;
+    coefficients[ 2 ] = c1;
+    coefficients[ 3 ] = 1.f;
+    coefficients[ 4 ] = c1 * 2.f * ( 1.f - nSquared );
+    coefficients[ 5 ] = c1 * ( 1.f - VST::SQRT_TWO * n + nSquared );
 }
 
 void LowPassFilter::applyFilter( float* samples, int amountOfSamples )
@@ -77,26 +87,4 @@ void LowPassFilter::resetFilter()
     y2 = 0.f;
 }
 
-/* private methods */
-
-void LowPassFilter::setFilterCoefficients( float c1, float c2, float c3, float c4, float c5, float c6 )
-{
-    // c4 is always passed as 1.f making the value of const float a equal to 1.f
-    /*
-    const float a = 1.f / c4;
-
-    c1 *= a;
-    c2 *= a;
-    c3 *= a;
-    c5 *= a;
-    c6 *= a;
-    */
-    coefficients[ 0 ] = c1;
-    coefficients[ 1 ] = c2;
-    coefficients[ 2 ] = c3;
-    coefficients[ 3 ] = c4;
-    coefficients[ 4 ] = c5;
-    coefficients[ 5 ] = c6;
-}
-
 }
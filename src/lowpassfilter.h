@@ -32,6 +32,12 @@ class LowPassFilter
         ~LowPassFilter();
 
         void setRatio( float frequencyRatio );
+
+        // calculates the 6 biquad coefficients of a 2nd order Butterworth
+        // lowpass filter for given frequency ratio into given coefficients array
+
+        static void calculateCoefficients( float frequencyRatio, float* coefficients );
+
         void applyFilter( float* samples, int bufferSize );
         void resetFilter();
 
@@ -53,9 +59,8 @@ class LowPassFilter
         }
 
     private:
-        void setFilterCoefficients( float c1, float c2, float c3, float c4, float c5, float c6 );
-
         float coefficients[ 6 ];
+        float _ratio = 0.f;
         float x1 = 0.f;
         float x2 = 0.f;
         float y1 = 0.f;
@@ -0,0 +1,141 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __LOWPASSFILTERBANK_H_INCLUDED__
+#define __LOWPASSFILTERBANK_H_INCLUDED__
+
+#include "lowpassfilter.h"
+#include <vector>
+
+namespace Igorski {
+/**
+ * A LowPassFilterBank runs the same 2nd order lowpass filter (e.g. sharing its
+ * coefficients) for multiple channels at once. The filter states of all channels
+ * are stored sequentially (struct of arrays) so a single step of the filter
+ * can be calculated for multiple channels in parallel by the CPU's vector units.
+ *
+ * Samples are provided per frame (e.g. a single sample for each channel), where the
+ * frame length must equal getStride() (the amount of channels padded to a multiple of the
+ * vector size, padding lanes should be kept silent). Layouts smaller than a single vector
+ * are not padded, as filtering the padding would cost more than it saves.
+ *
+ * SampleType describes the precision of the coefficients and filter states (e.g. float or double)
+ */
+template <typename SampleType>
+class LowPassFilterBank
+{
+    public:
+        // the amount of channels a single vector instruction can process for the target architecture
+
+#if defined( __AVX__ )
+        static constexpr int VECTOR_BYTES = 32;
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+        static constexpr int VECTOR_BYTES = 16;
+#else
+        static constexpr int VECTOR_BYTES = sizeof( SampleType );
+#endif
+        static constexpr int VECTOR_SIZE = VECTOR_BYTES / sizeof( SampleType );
+
+        LowPassFilterBank( int amountOfChannels );
+        ~LowPassFilterBank();
+
+        void setRatio( float frequencyRatio );
+        void resetFilters();
+
+        // the transposed direct form II topology is numerically more robust (particularly
+        // when the coefficients change rapidly) where the direct form I topology (default)
+        // provides the original character of the down sampling filter
+
+        void setTransposed( bool transposed );
+        bool isTransposed();
+
+        int getAmountOfChannels();
+        int getStride();
+
+        // filters given frame (of getStride() length) in place
+
+        inline void applyFrame( SampleType* frame ) {
+            const SampleType b0 = _coefficients[ 0 ];
+            const SampleType b1 = _coefficients[ 1 ];
+            const SampleType b2 = _coefficients[ 2 ];
+            const SampleType a1 = _coefficients[ 4 ];
+            const SampleType a2 = _coefficients[ 5 ];
+
+            if ( _transposed ) {
+                SampleType* z1 = _x1.data();
+                SampleType* z2 = _x2.data();
+
+                for ( int c = 0; c < _stride; ++c ) {
+                    SampleType in  = frame[ c ];
+                    SampleType out = b0 * in + z1[ c ];
+
+                    UNDENORMALISE( out );
+
+                    z1[ c ] = b1 * in - a1 * out + z2[ c ];
+                    z2[ c ] = b2 * in - a2 * out;
+
+                    frame[ c ] = out;
+                }
+                return;
+            }
+
+            SampleType* x1 = _x1.data();
+            SampleType* x2 = _x2.data();
+            SampleType* y1 = _y1.data();
+            SampleType* y2 = _y2.data();
+
+            for ( int c = 0; c < _stride; ++c ) {
+                SampleType in  = frame[ c ];
+                SampleType out = b0 * in + b1 * x1[ c ] + b2 * x2[ c ] - a1 * y1[ c ] - a2 * y2[ c ];
+
+                UNDENORMALISE( out );
+
+                x2[ c ] = x1[ c ];
+                x1[ c ] = in;
+                y2[ c ] = y1[ c ];
+                y1[ c ] = out;
+
+                frame[ c ] = out;
+            }
+        }
+
+    private:
+        int _amountOfChannels;
+        int _stride;
+        bool _transposed = false;
+
+        SampleType _coefficients[ 6 ];
+        float _ratio = 0.f;
+
+        // per channel filter states, for the direct form I topology these are the last two inputs and
+        // outputs, the transposed direct form II topology only uses _x1 and _x2 (as its state variables)
+
+        std::vector<SampleType> _x1;
+        std::vector<SampleType> _x2;
+        std::vector<SampleType> _y1;
+        std::vector<SampleType> _y2;
+};
+}
+
+#include "lowpassfilterbank.tcc"
+
+#endif
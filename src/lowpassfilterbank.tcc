@@ -0,0 +1,107 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+template <typename SampleType>
+LowPassFilterBank<SampleType>::LowPassFilterBank( int amountOfChannels )
+{
+    _amountOfChannels = amountOfChannels;
+    _stride = amountOfChannels < VECTOR_SIZE ? amountOfChannels : (( amountOfChannels + VECTOR_SIZE - 1 ) / VECTOR_SIZE ) * VECTOR_SIZE;
+
+    _x1.resize( _stride );
+    _x2.resize( _stride );
+    _y1.resize( _stride );
+    _y2.resize( _stride );
+
+    resetFilters();
+}
+
+template <typename SampleType>
+LowPassFilterBank<SampleType>::~LowPassFilterBank()
+{
+
+}
+
+/* public methods */
+
+template <typename SampleType>
+void LowPassFilterBank<SampleType>::setRatio( float frequencyRatio )
+{
+    if ( frequencyRatio == _ratio ) {
+        return; // coefficients are up to date
+    }
+    _ratio = frequencyRatio;
+
+    float coefficients[ 6 ];
+    LowPassFilter::calculateCoefficients( frequencyRatio, coefficients );
+
+    for ( int i = 0; i < 6; ++i ) {
+        _coefficients[ i ] = ( SampleType ) coefficients[ i ];
+    }
+}
+
+template <typename SampleType>
+void LowPassFilterBank<SampleType>::resetFilters()
+{
+    std::fill( _x1.begin(), _x1.end(), ( SampleType ) 0 );
+    std::fill( _x2.begin(), _x2.end(), ( SampleType ) 0 );
+    std::fill( _y1.begin(), _y1.end(), ( SampleType ) 0 );
+    std::fill( _y2.begin(), _y2.end(), ( SampleType ) 0 );
+}
+
+template <typename SampleType>
+void LowPassFilterBank<SampleType>::setTransposed( bool transposed )
+{
+    if ( transposed == _transposed ) {
+        return;
+    }
+    _transposed = transposed;
+
+    // the filter states have a different meaning across topologies
+
+    resetFilters();
+}
+
+template <typename SampleType>
+bool LowPassFilterBank<SampleType>::isTransposed()
+{
+    return _transposed;
+}
+
+template <typename SampleType>
+int LowPassFilterBank<SampleType>::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
+template <typename SampleType>
+int LowPassFilterBank<SampleType>::getStride()
+{
+    return _stride;
+}
+
+}
@@ -0,0 +1,86 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __OVERSAMPLER_H_INCLUDED__
+#define __OVERSAMPLER_H_INCLUDED__
+
+#include "halfbandfilter.h"
+#include <vector>
+
+namespace Igorski {
+/**
+ * An Oversampler changes the sampling rate of a signal by a factor of 2 or 4
+ * (using a cascade of half band filters), allowing nonlinear processes to run
+ * at a higher sampling rate so their harmonics do not fold back into the audible range.
+ *
+ * An instance holds the history of a single signal, and should be used for a single direction
+ * (e.g. upsampling the signal prior to processing or downsampling the processed signal).
+ * SampleType describes the precision of the signal (e.g. float or double).
+ */
+template <typename SampleType>
+class Oversampler
+{
+    public:
+        static constexpr int MAX_FACTOR = 4;
+
+        Oversampler( int factor );
+        ~Oversampler();
+
+        // 1 (disables oversampling), 2 or 4
+
+        void setFactor( int factor );
+        int getFactor();
+
+        // the delay (in samples at the original sampling rate) of upsampling and
+        // subsequently downsampling a signal by given factor
+
+        static int getLatency( int factor );
+
+        // writes bufferSize * factor samples into given out buffer
+
+        void upsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize );
+
+        // reads bufferSize * factor samples from given in buffer, writing bufferSize samples into given out buffer
+
+        void downsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize );
+
+        void reset();
+
+    private:
+        int _factor;
+
+        // at 4x, the first stage converts between the original and double sampling rate while
+        // the second stage converts between the double and quadruple sampling rate
+
+        HalfBandFilter<SampleType> _stages[ 2 ];
+        std::vector<SampleType> _intermediateBuffer; // the signal at double the sampling rate (4x only)
+
+        // at 4x, the signal at double the sampling rate is delayed by a single sample
+        // so the latency amounts to a whole amount of samples at the original rate
+
+        SampleType _delayedSample = 0;
+};
+}
+
+#include "oversampler.tcc"
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+template <typename SampleType>
+Oversampler<SampleType>::Oversampler( int factor )
+{
+    setFactor( factor );
+}
+
+template <typename SampleType>
+Oversampler<SampleType>::~Oversampler()
+{
+
+}
+
+/* public methods */
+
+template <typename SampleType>
+void Oversampler<SampleType>::setFactor( int factor )
+{
+    _factor = factor >= MAX_FACTOR ? MAX_FACTOR : ( factor >= 2 ? 2 : 1 );
+    reset();
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getFactor()
+{
+    return _factor;
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getLatency( int factor )
+{
+    // each half band filter pass delays the signal by HalfBandFilter<SampleType>::DELAY samples at its higher rate
+
+    switch ( factor ) {
+        default:
+            return 0;
+        case 2:
+            return HalfBandFilter<SampleType>::DELAY;
+        case 4:
+            return HalfBandFilter<SampleType>::DELAY + ( HalfBandFilter<SampleType>::DELAY + 1 ) / 2;
+    }
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::upsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize )
+{
+    if ( _factor == 1 ) {
+        std::copy( inBuffer, inBuffer + bufferSize, outBuffer );
+        return;
+    }
+
+    if ( _factor == 2 ) {
+        _stages[ 0 ].upsample( inBuffer, outBuffer, bufferSize );
+        return;
+    }
+
+    if (( int ) _intermediateBuffer.size() < bufferSize * 2 ) {
+        _intermediateBuffer.resize( bufferSize * 2 );
+    }
+    SampleType* intermediate = _intermediateBuffer.data();
+
+    _stages[ 0 ].upsample( inBuffer, intermediate, bufferSize );
+    _stages[ 1 ].upsample( intermediate, outBuffer, bufferSize * 2 );
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::downsample( const SampleType* inBuffer, SampleType* outBuffer, int bufferSize )
+{
+    if ( _factor == 1 ) {
+        std::copy( inBuffer, inBuffer + bufferSize, outBuffer );
+        return;
+    }
+
+    if ( _factor == 2 ) {
+        _stages[ 0 ].downsample( inBuffer, outBuffer, bufferSize );
+        return;
+    }
+
+    if (( int ) _intermediateBuffer.size() < bufferSize * 2 ) {
+        _intermediateBuffer.resize( bufferSize * 2 );
+    }
+    SampleType* intermediate = _intermediateBuffer.data();
+    int intermediateSize = bufferSize * 2;
+
+    _stages[ 1 ].downsample( inBuffer, intermediate, intermediateSize );
+
+    // delay by a single sample (see header)
+
+    SampleType lastSample = intermediate[ intermediateSize - 1 ];
+    for ( int i = intermediateSize - 1; i > 0; --i ) {
+        intermediate[ i ] = intermediate[ i - 1 ];
+    }
+    intermediate[ 0 ] = _delayedSample;
+    _delayedSample    = lastSample;
+
+    _stages[ 0 ].downsample( intermediate, outBuffer, bufferSize );
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset()
+{
+    _stages[ 0 ].reset();
+    _stages[ 1 ].reset();
+    _delayedSample = ( SampleType ) 0;
+}
+
+}
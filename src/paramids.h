@@ -44,8 +44,21 @@ enum
 
 // --- AUTO-GENERATED END
 
-    kBypassId, // bypass process
-    kVuPPMId // for the Vu value return to host
+    kBypassId,        // bypass process
+    kVuPPMId,         // for the Vu value return to host (output peak level)
+    kLfoSyncId,       // synchronizes the LFO rates to the host tempo
+    kOutputRmsId,     // output RMS level returned to host
+    kGainReductionId, // limiter gain reduction returned to host
+    kSaveRecordingId,         // stores the recorded audio in the plugin state
+    kSideChainResampleId,     // depth by which the side chain envelope lowers the resample rate
+    kSideChainBitDepthId,     // depth by which the side chain envelope lowers the resolution
+    kSideChainPlaybackRateId, // depth by which the side chain envelope lowers the playback rate
+    kLimiterLookaheadId,      // enables the lookahead of the limiter (adds latency)
+    kCleanDownSamplingId,     // down samples using an anti-aliasing filter instead of the character filter
+    kOversamplingId,          // oversampling factor of the bit crusher and limiter (adds latency)
+    kInterpolationId,         // interpolation quality used when reading the recording at a fractional position
+    kLfoInterpolationId,      // interpolates the LFO wave tables (smoother modulation) instead of holding each entry
+    kStableFilterId           // runs the character filter in a topology that remains stable under rapid modulation
 };
 
 #endif
@@ -24,21 +24,14 @@
 #include "calc.h"
 #include <math.h>
 #include <algorithm>
+#include <thread>
 
 namespace Igorski {
 
 PluginProcess::PluginProcess( int amountOfChannels )
 {
-    _amountOfChannels = amountOfChannels;
     cacheMaxDownSample();
 
-     _lastSamples = new float[ amountOfChannels ];
-
-    for ( int i = 0; i < amountOfChannels; ++i ) {
-        _lastSamples[ i ] = 0.f;
-        _lowPassFilters.push_back( new LowPassFilter());
-    }
-
     _dryMix = 0.f;
     _wetMix = 1.f;
 
@@ -47,9 +40,14 @@ PluginProcess::PluginProcess( int amountOfChannels )
     bitCrusher = new BitCrusher( 1.f, .5f, 1.f );
     limiter    = new Limiter( 0.3f, 0.5f, 0.9f, true );
 
-    // buffers will be lazily created in the process function as they correspond to the host buffer size
-    _recordBuffer  = nullptr;
-    _preMixBuffer  = nullptr;
+    setAmountOfChannels( amountOfChannels );
+
+    _decimationFilter = new DecimationFilter();
+    _interpolator     = new Interpolator();
+
+    // the kernels for clean down sampling are calculated up front, so the mode can be toggled while processing
+
+    _decimationFilter->prepare(( int ) ceil( _maxDownSample ));
 
     // oscillators
     _downSampleLfo      = new LFO();
@@ -73,23 +71,57 @@ PluginProcess::PluginProcess( int amountOfChannels )
 
 PluginProcess::~PluginProcess()
 {
-    delete[] _lastSamples;
-
-    while ( _lowPassFilters.size() > 0 ) {
-        delete _lowPassFilters.at( 0 );
-        _lowPassFilters.erase( _lowPassFilters.begin() );
-    }
-
+    delete _decimationFilter;
+    delete _interpolator;
+    delete _workerPool;
     delete bitCrusher;
     delete limiter;
-    delete _recordBuffer;
-    delete _preMixBuffer;
     delete _downSampleLfo;
     delete _playbackRateLfo;
 }
 
 /* setters */
 
+void PluginProcess::setAmountOfChannels( int amountOfChannels )
+{
+    if ( amountOfChannels == _amountOfChannels ) {
+        return;
+    }
+
+    _amountOfChannels = amountOfChannels;
+
+    _ditherSeeds.resize( amountOfChannels );
+    _restoreChannels.resize( amountOfChannels );
+    _ditherValues.resize( amountOfChannels );
+
+    for ( int i = 0; i < amountOfChannels; ++i ) {
+        _ditherSeeds[ i ]  = 22222u + ( uint32_t ) i * 7919u;
+        _ditherValues[ i ] = 0;
+    }
+
+    // the buffers will be recreated for the new amount of channels in the next process cycle
+
+    limiter->setAmountOfChannels( amountOfChannels );
+
+    createWorkerPool();
+
+    _floatPath.setAmountOfChannels( amountOfChannels, _oversampling );
+    _doublePath.setAmountOfChannels( amountOfChannels, _oversampling );
+    setTransposedFilter( _transposedFilter ); // the filter banks have been recreated
+    _lastBufferSize = 0;
+
+#ifdef HC_PROFILE
+    profiler.setAmountOfChannels( amountOfChannels );
+#endif
+
+    resetReadWritePointers();
+}
+
+int PluginProcess::getAmountOfChannels()
+{
+    return _amountOfChannels;
+}
+
 void PluginProcess::setDryMix( float value )
 {
     _dryMix = value;
@@ -132,12 +164,14 @@ void PluginProcess::setResampleLfo( float LFORatePercentage, float LFODepth )
 
     bool hadChange = ( wasEnabled != enabled ) || _downSampleLfoDepth != LFODepth;
 
-    if ( enabled )
+    if ( enabled ) {
         _downSampleLfo->setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
         );
+        _downSampleLfo->setSyncedRate( LFORatePercentage );
+    }
 
     // turning LFO off
     if ( !_hasDownSampleLfo && wasEnabled ) {
@@ -170,6 +204,11 @@ void PluginProcess::setPlaybackRate( float value )
     cacheLfo();
 }
 
+void PluginProcess::scheduleRates( int offset, float resampleRate, float playbackRate )
+{
+    _rateChanges.push_back({ offset, resampleRate, playbackRate });
+}
+
 void PluginProcess::setPlaybackRateLfo( float LFORatePercentage, float LFODepth )
 {
     bool wasEnabled = _hasPlaybackRateLfo;
@@ -179,12 +218,14 @@ void PluginProcess::setPlaybackRateLfo( float LFORatePercentage, float LFODepth
 
     bool hadChange = ( wasEnabled != enabled ) || _playbackRateLfoDepth != LFODepth;
 
-    if ( enabled )
+    if ( enabled ) {
         _playbackRateLfo->setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
         );
+        _playbackRateLfo->setSyncedRate( LFORatePercentage );
+    }
 
     // turning LFO off
     if ( !_hasPlaybackRateLfo && wasEnabled ) {
@@ -197,17 +238,168 @@ void PluginProcess::setPlaybackRateLfo( float LFORatePercentage, float LFODepth
     }
 }
 
+void PluginProcess::setTempoSync( bool enabled )
+{
+    _downSampleLfo->setTempoSync( enabled );
+    _playbackRateLfo->setTempoSync( enabled );
+    bitCrusher->lfo->setTempoSync( enabled );
+}
+
+bool PluginProcess::isTempoSynced()
+{
+    return _downSampleLfo->isTempoSynced();
+}
+
+void PluginProcess::setLfoInterpolation( bool enabled )
+{
+    _downSampleLfo->setInterpolated( enabled );
+    _playbackRateLfo->setInterpolated( enabled );
+    bitCrusher->lfo->setInterpolated( enabled );
+}
+
+bool PluginProcess::isLfoInterpolated()
+{
+    return _downSampleLfo->isInterpolated();
+}
+
+void PluginProcess::setTempo( double tempo, double projectTimeMusic, bool hasPosition )
+{
+    LFO* oscillators[ 3 ] = { _downSampleLfo, _playbackRateLfo, bitCrusher->lfo };
+
+    for ( LFO* lfo : oscillators ) {
+        lfo->setTempo( tempo );
+
+        // when synchronized, the phase follows the position of the (playing) host sequencer
+        // otherwise the oscillators run freely (at the rate of the synchronized note division)
+
+        if ( hasPosition && lfo->isTempoSynced()) {
+            lfo->syncToPosition( projectTimeMusic );
+        }
+    }
+}
+
+void PluginProcess::setMultiThreaded( bool enabled )
+{
+    if ( enabled == _multiThreaded ) {
+        return;
+    }
+    _multiThreaded = enabled;
+
+    createWorkerPool();
+}
+
+bool PluginProcess::isMultiThreaded()
+{
+    return _workerPool != nullptr;
+}
+
+void PluginProcess::setCleanDownSampling( bool enabled )
+{
+    _cleanDownSampling = enabled;
+}
+
+bool PluginProcess::isCleanDownSampling()
+{
+    return _cleanDownSampling;
+}
+
+void PluginProcess::setTransposedFilter( bool enabled )
+{
+    _transposedFilter = enabled;
+
+    _floatPath.lowPassFilterBank->setTransposed( enabled );
+    _doublePath.lowPassFilterBank->setTransposed( enabled );
+}
+
+bool PluginProcess::isTransposedFilter()
+{
+    return _transposedFilter;
+}
+
 void PluginProcess::resetReadWritePointers()
 {
     _readPointer  = 0.f;
     _writePointer = 0;
+    _readLag      = 0.f;
+
+    _unfinishedSegmentLength = 0;
 }
 
 void PluginProcess::clearBuffer()
 {
-    if ( _recordBuffer != nullptr ) {
-        _recordBuffer->silenceBuffers();
+    if ( _floatPath.recordBuffer != nullptr ) {
+        _floatPath.recordBuffer->silenceBuffers();
+    }
+    if ( _doublePath.recordBuffer != nullptr ) {
+        _doublePath.recordBuffer->silenceBuffers();
     }
+    waveformOverview.clear();
+}
+
+void PluginProcess::setInterpolationQuality( Interpolator::Quality quality )
+{
+    _interpolator->setQuality( quality );
+}
+
+Interpolator::Quality PluginProcess::getInterpolationQuality()
+{
+    return _interpolator->getQuality();
+}
+
+void PluginProcess::setOversampling( int factor )
+{
+    factor = Oversampler<float>( factor ).getFactor(); // sanitizes the factor
+
+    if ( factor == _oversampling ) {
+        return;
+    }
+    _oversampling = factor;
+
+    limiter->setOversampling( _oversampling );
+
+    _floatPath.createOversamplers( _amountOfChannels, _oversampling );
+    _doublePath.createOversamplers( _amountOfChannels, _oversampling );
+
+    _floatPath.deleteOversampledBuffers();
+    _doublePath.deleteOversampledBuffers();
+
+    if ( _floatPath.lastBufferSize > 0 ) {
+        _floatPath.prepareOversampledBuffers( _amountOfChannels, _floatPath.lastBufferSize, _oversampling );
+    }
+    if ( _doublePath.lastBufferSize > 0 ) {
+        _doublePath.prepareOversampledBuffers( _amountOfChannels, _doublePath.lastBufferSize, _oversampling );
+    }
+}
+
+int PluginProcess::getOversampling()
+{
+    return _oversampling;
+}
+
+void PluginProcess::setDeterministic( bool enabled )
+{
+    if ( enabled == _deterministic ) {
+        return;
+    }
+    _deterministic = enabled;
+
+    // the size of the record buffer depends on the mode, the buffers
+    // will be recreated in the next process cycle (see prepareMixBuffers())
+
+    _floatPath.deleteBuffers();
+    _doublePath.deleteBuffers();
+
+    resetReadWritePointers();
+}
+
+bool PluginProcess::isDeterministic()
+{
+    return _deterministic;
+}
+
+int PluginProcess::getLatency()
+{
+    return limiter->getLatency() + Oversampler<float>::getLatency( _oversampling ) + ( _cleanDownSampling ? getCleanDelay() : 0 );
 }
 
 /* private methods */
@@ -217,12 +409,9 @@ void PluginProcess::cacheDownSamplingValues()
     _fSampleIncr = std::max( 1.f, floor( _actualDownSampleAmount ));
     _sampleIncr  = ( int ) _fSampleIncr;
 
-    // update the lowpass filters to the appropriate cutoff
+    // the lowpass filters are updated to the appropriate cutoff when processing (see calculateReadSegments())
 
-    float ratio = 1.f + ( _actualDownSampleAmount / _maxDownSample );
-    for ( int c = 0; c < _amountOfChannels; ++c ) {
-        _lowPassFilters.at( c )->setRatio( ratio );
-    }
+    _filterRatio = 1.f + ( _actualDownSampleAmount / _maxDownSample );
 }
 
 void PluginProcess::cacheLfo()
@@ -253,10 +442,205 @@ void PluginProcess::setActualDownSampling( float value )
     // and no playback slowdown taking place: sync the read pointer with the write pointer
 
     if ( wasDownSampled && !isDownSampled() && !_hasDownSampleLfo && !isSlowedDown() && !_hasPlaybackRateLfo ) {
-        _readPointer = ( float ) _writePointer;
+        syncReadPointer();
     }
 }
 
+int PluginProcess::calculateReadSegments( int bufferSize )
+{
+    int maxReadOffset = _writePointer + bufferSize - 1; // never read beyond the range of the current incoming input
+    int writePointer  = getNextWritePointer( bufferSize );
+
+    float readPointer = _readPointer;
+    float incr, lfoValue;
+    int i = 0, l, start;
+    int amountOfSegments = 0;
+    bool hasRateChanges = !_rateChanges.empty();
+
+    // in deterministic mode the read position can trail the write position up until the point where the
+    // record buffer no longer holds the history required by the decimation filter and interpolator
+
+    float maxReadLag = ( float ) ( _maxRecordBufferSize - DecimationFilter::TAPS_PER_RATIO * (( int ) _maxDownSample + 1 ) - Interpolator::MAX_TAPS );
+
+    // the oscillators are rendered for the entire buffer upfront
+
+    if ( _hasDownSampleLfo ) {
+        _downSampleLfo->render( _downSampleLfoValues.data(), bufferSize );
+    }
+    if ( _hasPlaybackRateLfo ) {
+        _playbackRateLfo->render( _playbackRateLfoValues.data(), bufferSize );
+    }
+
+    while ( i < bufferSize ) {
+        if ( hasRateChanges ) {
+            applyScheduledRates( i, readPointer );
+        }
+        ReadSegment& segment = _readSegments[ amountOfSegments++ ];
+
+        if ( _unfinishedSegmentLength > 0 ) {
+            // continue the segment that didn't finish within the previous process cycle (deterministic mode only)
+            segment = _unfinishedSegment;
+            segment.offset = _unfinishedSegmentLength;
+        } else {
+            if ( _deterministic ) {
+                int lag = ( int ) ceil( _readLag );
+                segment.readOffset = getWriteIndex( i ) - lag;
+                segment.fraction   = ( float ) lag - _readLag;
+
+                if ( segment.readOffset < 0 ) {
+                    segment.readOffset += _maxRecordBufferSize;
+                }
+            } else {
+                segment.readOffset = ( int ) readPointer;
+                segment.fraction   = readPointer - ( float ) segment.readOffset;
+            }
+            segment.sampleIncr  = _sampleIncr;
+            segment.filterRatio = _filterRatio;
+            segment.offset      = 0;
+        }
+        segment.start = i;
+        start = i - segment.offset; // precedes the current buffer when the segment is continued
+
+        for ( l = std::min( bufferSize, start + _sampleIncr ); i < l; ++i ) {
+
+            // apply the rates scheduled for the current sample, when this shortens the segment up until
+            // the current sample, the sample starts the next segment (as it would have at the start of a cycle)
+
+            if ( hasRateChanges ) {
+                applyScheduledRates( i, readPointer );
+                l = std::min( bufferSize, start + _sampleIncr );
+
+                if ( i >= l ) {
+                    break;
+                }
+            }
+
+            // run the oscillators, note we multiply by .5 and add .5 to make the LFO's bipolar waveforms unipolar
+
+            if ( _hasDownSampleLfo ) {
+                lfoValue = _downSampleLfoValues[ i ] * .5f + .5f;
+                setActualDownSampling( std::min( _downSampleLfoMax, _downSampleLfoMin + _downSampleLfoRange * lfoValue ) * _maxDownSample );
+                l = std::min( bufferSize, start + _sampleIncr );
+            }
+
+            if ( _hasPlaybackRateLfo ) {
+                lfoValue = _playbackRateLfoValues[ i ] * .5f + .5f;
+                setActualPlaybackRate( std::min( _playbackRateLfoMax, _playbackRateLfoMin + _playbackRateLfoRange * lfoValue ));
+            }
+        }
+        segment.end = i;
+
+        // by default, segments are truncated at the end of the buffer. In deterministic mode the
+        // segment continues in the next process cycle (as it would have, had the buffer been larger)
+
+        segment.finished = !_deterministic || i >= start + _sampleIncr;
+
+        if ( !segment.finished ) {
+            _unfinishedSegment       = segment;
+            _unfinishedSegmentLength = i - start;
+            break;
+        }
+        _unfinishedSegmentLength = 0;
+
+        // note we cannot cache the increment value as its parts are altered by the oscillators in the render cycle above
+        incr = _fSampleIncr * _actualPlaybackRate;
+
+        if ( _deterministic ) {
+            // the write position advanced by the length of the segment while the read position advanced by incr
+            _readLag += ( float ) ( i - start ) - incr;
+
+            if ( _readLag < 0.f || _readLag > maxReadLag ) {
+                _readLag = 0.f; // read position overtook the write position or exceeded the recorded history
+            }
+        } else if (( readPointer += incr ) > maxReadOffset ) {
+            readPointer = ( float ) writePointer; // don't go to 0.f but align with last write offset to play "current audio"
+        }
+    }
+    _readPointer = readPointer;
+
+    _rateChanges.clear();
+    _appliedRateChanges = 0;
+
+    return amountOfSegments;
+}
+
+void PluginProcess::applyScheduledRates( int offset, float& readPointer )
+{
+    int amountOfChanges = ( int ) _rateChanges.size();
+
+    if ( _appliedRateChanges == amountOfChanges || _rateChanges[ _appliedRateChanges ].offset > offset ) {
+        return;
+    }
+
+    // deactivating the down sampling or slowed down playback syncs the read pointer (see setActualDownSampling()),
+    // which within the process cycle corresponds with the write position of the current sample
+
+    _readPointer = readPointer;
+
+    while ( _appliedRateChanges < amountOfChanges && _rateChanges[ _appliedRateChanges ].offset <= offset ) {
+        const RateChange& change = _rateChanges[ _appliedRateChanges++ ];
+
+        setResampleRate( change.resampleRate );
+        setPlaybackRate( change.playbackRate );
+    }
+
+    if ( _readPointer != readPointer ) {
+        readPointer = _readPointer = ( float ) getWriteIndex( offset );
+    }
+}
+
+const uint32_t* PluginProcess::generateDither( int channel, int bufferSize )
+{
+    uint32_t* seeds = _ditherBuffers[ channel ].data();
+
+    // the first entry provides the last noise value of the previous process cycle
+
+    seeds[ 0 ] = ( uint32_t ) _ditherValues[ channel ] << 1;
+
+    // calculate the states for the first lanes sequentially, the subsequent states are calculated
+    // DITHER_LANES steps ahead of these (allowing the compiler to vectorize the calculation)
+
+    uint32_t seed       = _ditherSeeds[ channel ];
+    uint32_t multiplier = 1;
+    uint32_t increment  = 0;
+
+    for ( int i = 1; i <= DITHER_LANES; ++i ) {
+        nextDitherValue( seed );
+        seeds[ i ] = seed;
+
+        increment  = increment * DITHER_MULTIPLIER + DITHER_INCREMENT;
+        multiplier = multiplier * DITHER_MULTIPLIER;
+    }
+
+    int size = ( int ) _ditherBuffers[ channel ].size();
+
+    for ( int i = DITHER_LANES + 1; i < size; ++i ) {
+        seeds[ i ] = seeds[ i - DITHER_LANES ] * multiplier + increment;
+    }
+
+    _ditherSeeds[ channel ]  = seeds[ bufferSize ];
+    _ditherValues[ channel ] = ( int32_t )( seeds[ bufferSize ] >> 1 );
+
+    return seeds;
+}
+
+int PluginProcess::getNextWritePointer( int bufferSize )
+{
+    // mirrors the wrapping behaviour of the recording loop in processChannel()
+
+    int writePointer = ( _writePointer > ( _maxRecordBufferSize - 1 ) ? 0 : _writePointer ) + bufferSize;
+    if ( writePointer > _maxRecordBufferSize ) {
+        writePointer -= _maxRecordBufferSize;
+    }
+    return writePointer;
+}
+
+int PluginProcess::getWriteIndex( int sample )
+{
+    int writeIndex = ( _writePointer > ( _maxRecordBufferSize - 1 ) ? 0 : _writePointer ) + sample;
+    return writeIndex >= _maxRecordBufferSize ? writeIndex - _maxRecordBufferSize : writeIndex;
+}
+
 void PluginProcess::setActualPlaybackRate( float value )
 {
     bool wasSlowedDown  = isSlowedDown();
@@ -266,7 +650,47 @@ void PluginProcess::setActualPlaybackRate( float value )
     // and no down sampling taking place: sync the read pointer with the write pointer
 
     if ( wasSlowedDown && !isSlowedDown() && !_hasPlaybackRateLfo && !isDownSampled() ) {
-        _readPointer = ( float ) _writePointer;
+        syncReadPointer();
+    }
+}
+
+void PluginProcess::syncReadPointer()
+{
+    _readPointer = ( float ) _writePointer;
+    _readLag     = 0.f;
+}
+
+float PluginProcess::getReadPosition()
+{
+    if ( !_deterministic ) {
+        return _readPointer;
+    }
+    float readPosition = ( float ) getWriteIndex( 0 ) - _readLag;
+    return readPosition < 0.f ? readPosition + ( float ) _maxRecordBufferSize : readPosition;
+}
+
+int PluginProcess::getCleanDelay()
+{
+    // the delay of the kernel for the highest decimation ratio applies to all ratios (see filterReadSegments())
+
+    return _decimationFilter->getDelay( _decimationFilter->getMaxRatio());
+}
+
+void PluginProcess::createWorkerPool()
+{
+    delete _workerPool;
+    _workerPool = nullptr;
+
+    if ( !_multiThreaded || _amountOfChannels < MIN_CHANNELS_PER_POOL ) {
+        return;
+    }
+
+    // the thread invoking process() also participates, hence we subtract one from the amount of cores
+    // (and from the amount of channels, as more workers than channels would be woken up without a task)
+
+    int amountOfWorkers = std::min(( int ) std::thread::hardware_concurrency(), _amountOfChannels ) - 1;
+    if ( amountOfWorkers > 0 ) {
+        _workerPool = new WorkerPool( std::min( amountOfWorkers, WorkerPool::MAX_WORKERS ));
     }
 }
 
@@ -27,7 +27,17 @@
 #include "audiobuffer.h"
 #include "bitcrusher.h"
 #include "limiter.h"
-#include "lowpassfilter.h"
+#include "decimationfilter.h"
+#include "denormalguard.h"
+#include "interpolator.h"
+#include "lowpassfilterbank.h"
+#include "oversampler.h"
+#include "profiler.h"
+#include "recordingstore.h"
+#include "spectrumanalyzer.h"
+#include "waveformoverview.h"
+#include "workerpool.h"
+#include <cstdint>
 #include <vector>
 
 using namespace Steinberg;
@@ -37,10 +47,12 @@ class PluginProcess
 {
     // dithering constants
 
+    static constexpr float DITHER_MAX = 2147483647.f; // range of the dither noise generator (see nextDitherValue())
+
     const float DITHER_WORD_LENGTH = pow( 2.0, 15 );        // 15 implies 16-bit depth
     const float DITHER_WI          = 1.0f / DITHER_WORD_LENGTH;
     const float DITHER_DC_OFFSET   = DITHER_WI * 0.5f;      // apply in resampling routine to remove DC offset
-    const float DITHER_AMPLITUDE   = DITHER_WI / RAND_MAX;  // 2 LSB
+    const float DITHER_AMPLITUDE   = DITHER_WI / DITHER_MAX; // 2 LSB
 
     public:
         static constexpr float MAX_RECORD_SECONDS = 30.f;
@@ -50,6 +62,12 @@ class PluginProcess
         PluginProcess( int amountOfChannels );
         ~PluginProcess();
 
+        // (re)allocates the per-channel resources, should be invoked when the
+        // host negotiated a different bus arrangement (not during processing!)
+
+        void setAmountOfChannels( int amountOfChannels );
+        int getAmountOfChannels();
+
         // apply effect to incoming sampleBuffer contents
 
         template <typename SampleType>
@@ -86,12 +104,93 @@ class PluginProcess
         void setPlaybackRateLfo( float LFORatePercentage, float LFODepth );
         void setDryMix( float value );
         void setWetMix( float value );
+
+        // schedules the resample and playback rate (as provided to their setters) to apply from given sample offset
+        // within the next process cycle, so control rate modulation (e.g. by the side chain envelope) can change the
+        // rates within a process cycle without splitting it. Changes must be scheduled in order of their offset
+
+        void scheduleRates( int offset, float resampleRate, float playbackRate );
+
+        // when enabled, the oscillator rates are note divisions of the host tempo (see LFO::setSyncedRate())
+        // provide the host tempo and the position of the current process cycle using setTempo()
+
+        void setTempoSync( bool enabled );
+        bool isTempoSynced();
+        void setTempo( double tempo, double projectTimeMusic, bool hasPosition );
+
+        // when enabled, the oscillators interpolate in between their wave table entries for a smoother
+        // modulation, otherwise the preceding table entry is held (see LFO::setInterpolated())
+
+        void setLfoInterpolation( bool enabled );
+        bool isLfoInterpolated();
+
+        // when enabled, channels are processed in parallel by a pool of worker threads. This is
+        // intended for offline rendering of wide channel layouts (not during processing!). For narrow
+        // channel layouts (see MIN_CHANNELS_PER_POOL) waking the workers costs more than it saves,
+        // hence these remain processed by the calling thread
+
+        void setMultiThreaded( bool enabled );
+        bool isMultiThreaded();
+
+        // when enabled, down sampling uses a steep anti-aliasing filter instead of the
+        // (intentionally aliasing) character filter, for a "clean" reduction of the sample rate. As
+        // the filter delays the signal, this adds to the latency (not during processing!)
+
+        void setCleanDownSampling( bool enabled );
+        bool isCleanDownSampling();
+
+        // when enabled, the character filter uses the transposed direct form II topology which remains
+        // stable under rapid modulation of the resample rate (see LowPassFilterBank::setTransposed())
+
+        void setTransposedFilter( bool enabled );
+        bool isTransposedFilter();
+
+        // the interpolation used when reading the recorded signal at a fractional position (e.g. when
+        // the playback rate is slowed down). Interpolator::HOLD (default) provides the original character
+
+        void setInterpolationQuality( Interpolator::Quality quality );
+        Interpolator::Quality getInterpolationQuality();
+
+        // runs the bit crusher and limiter at given factor (1, 2 or 4) times the sample rate to reduce
+        // the aliasing of these nonlinear processes. This adds to the latency (not during processing!)
+
+        void setOversampling( int factor );
+        int getOversampling();
+
+        // when enabled, identical input renders bit-identical output regardless of how the host partitions
+        // it into process cycles (e.g. the block size solely affects performance). This uses a record buffer
+        // of fixed size and lets read segments continue across process cycles (not during processing!)
+
+        void setDeterministic( bool enabled );
+        bool isDeterministic();
+
         void resetReadWritePointers(); // invoke on host sequencer start
         void clearBuffer();            // flushes record buffer
 
+        // the amount of samples the output is delayed by (e.g. when using the limiters lookahead)
+
+        int getLatency();
+
         BitCrusher* bitCrusher;
         Limiter*    limiter;
 
+        // overview of the record buffer contents (published for display in the editor, see WaveformOverview)
+
+        WaveformOverview waveformOverview;
+
+        // spectra of the input and output signal (analyzed outside of the process thread, see SpectrumAnalyzer)
+
+        SpectrumAnalyzer spectrumAnalyzer;
+
+        // (optional) copy of the recording for storage in the plugin state, recordings loaded into
+        // the store are restored into the record buffer on the next process cycles (see restoreRecording())
+
+        RecordingStore recordingStore;
+
+#ifdef HC_PROFILE
+        Profiler profiler; // the cycles spent in each stage of the process cycle
+#endif
+
         inline bool isSlowedDown() {
             return _actualPlaybackRate < 1.f;
         }
@@ -105,14 +204,117 @@ class PluginProcess
         }
 
     private:
-        AudioBuffer* _recordBuffer; // buffer used to record incoming signal
-        AudioBuffer* _preMixBuffer; // buffer used for the pre-effect mixing
-        int _lastBufferSize = 0;    // size of the last buffer used when generating the _recordBuffer
+        // the buffers and processors of the signal path exist for each precision the host can process in
+        // (see process()), so double precision hosts are processed without conversion to float. The buffers
+        // are lazily created in the process function as they correspond to the host buffer size
+
+        template <typename SampleType>
+        struct SignalPath {
+            AudioBuffer<SampleType>* recordBuffer = nullptr; // buffer used to record incoming signal
+            AudioBuffer<SampleType>* preMixBuffer = nullptr; // buffer used for the pre-effect mixing
+            AudioBuffer<SampleType>* dryBuffer    = nullptr; // the delayed input signal (when down sampling cleanly)
+            int lastBufferSize = 0; // size of the last buffer used when generating the recordBuffer
+
+            LowPassFilterBank<SampleType>* lowPassFilterBank = nullptr;
+            std::vector<SampleType> filteredSamples;     // filtered sample for each read segment (in frames of the banks stride)
+            std::vector<SampleType> interpolatedSamples; // interpolated sample for each read segment (of a single channel)
+            std::vector<SampleType> lastSamples;         // last written sample, per channel
+
+            // the held sample of a read segment that continues into the next process cycle, per channel (see processChannel())
+
+            struct HeldSegment {
+                SampleType heldSample;
+                SampleType convergedSample;
+                SampleType decay;
+            };
+            std::vector<HeldSegment> unfinishedSegments;
+
+            // oversampling (each channel has its own resamplers for the wet and dry signals and the output)
+
+            std::vector<Oversampler<SampleType>> wetUpsamplers;
+            std::vector<Oversampler<SampleType>> dryUpsamplers;
+            std::vector<Oversampler<SampleType>> downsamplers;
+            AudioBuffer<SampleType>* oversampledBuffer    = nullptr; // the oversampled output (prior to limiting)
+            AudioBuffer<SampleType>* oversampledDryBuffer = nullptr;
+            std::vector<SampleType*> oversampledChannels;            // the channels of the oversampledBuffer
+
+            ~SignalPath();
+
+            void setAmountOfChannels( int amountOfChannels, int oversampling );
+            void createOversamplers( int amountOfChannels, int oversampling );
+            void prepareOversampledBuffers( int amountOfChannels, int bufferSize, int oversampling );
+            void deleteOversampledBuffers();
+            void deleteBuffers();
+        };
+
+        SignalPath<float>  _floatPath;
+        SignalPath<double> _doublePath;
+
+        template <typename SampleType>
+        SignalPath<SampleType>& getSignalPath();
+
+        int _lastBufferSize = 0; // size of the last buffer used when generating the read segments and dither buffers
+
+        // multi threaded processing (only when processing the given minimum amount of channels)
+
+        static const int MIN_CHANNELS_PER_POOL = 8;
+        WorkerPool* _workerPool = nullptr;
+        bool _multiThreaded     = false;
+
+        void createWorkerPool();
+
+        template <typename SampleType>
+        struct ChannelTask {
+            PluginProcess* process;
+            SampleType** inBuffer;
+            SampleType** outBuffer;
+            int bufferSize;
+            int amountOfSegments;
+
+            static void run( void* context, int channel ) {
+                // floating point modes are set per thread, as such the workers require their own guard
+                DenormalGuard denormalGuard;
+
+                ChannelTask* task = ( ChannelTask* ) context;
+                task->process->processChannel<SampleType>(
+                    channel, task->inBuffer, task->outBuffer, task->bufferSize, task->amountOfSegments
+                );
+            }
+        };
 
         float _dryMix;
         float _wetMix;
-        int _amountOfChannels;
-        std::vector<LowPassFilter*> _lowPassFilters;
+        int _amountOfChannels = 0;
+        float _filterRatio; // current cutoff ratio of the lowpass filters, relative to the down sampling amount
+
+        bool _cleanDownSampling = false;
+        bool _transposedFilter  = false;
+        DecimationFilter* _decimationFilter;
+        Interpolator* _interpolator;
+
+        int _oversampling = 1;
+        bool _deterministic = false;
+
+        // a read segment describes a range in the output buffer that is filled with
+        // a single (held) sample read from the record buffer. As the read range is
+        // equal for all channels, these are calculated once per process cycle
+
+        struct ReadSegment {
+            int start;         // first index in the output buffer
+            int end;           // last index (exclusive) in the output buffer
+            int readOffset;    // index in the record buffer to read the sample from
+            float fraction;    // fractional part of the read position (beyond readOffset)
+            int sampleIncr;    // the down sampling amount at the moment of reading
+            float filterRatio; // the lowpass filter ratio at the moment of reading
+            int offset;        // amount of samples of the segment rendered in previous process cycles
+            bool finished;     // whether the segment ends within the current process cycle
+        };
+        std::vector<ReadSegment> _readSegments;
+
+        // in deterministic mode, a segment can span multiple process cycles (see calculateReadSegments())
+
+        ReadSegment _unfinishedSegment;
+        int _unfinishedSegmentLength = 0; // amount of samples of the unfinished segment rendered so far
 
         // read/write pointers for the record buffer used for record and playback
 
@@ -120,12 +322,59 @@ class PluginProcess
         int _writePointer;
         int _maxRecordBufferSize;
 
+        // in deterministic mode, the read position is tracked relative to the write position of each sample (rather
+        // than as an absolute record buffer index) so it doesn't depend on the buffer size or when the buffer wraps
+
+        float _readLag = 0.f;
+
+        // moves the read position onto the write position (e.g. to play "current audio")
+
+        void syncReadPointer();
+
+        // the current read position as a record buffer index (regardless of deterministic mode)
+
+        float getReadPosition();
+
         // down sampling
 
         float  _downSampleAmount; // 1 == no change (keeps at original sample rate), > 1 provides down sampling
         float  _actualDownSampleAmount;
         float  _maxDownSample;
-        float* _lastSamples; // last written sample, per channel
+
+        // dithering (noise generator state and last generated value, per channel)
+
+        std::vector<uint32_t> _ditherSeeds;
+        std::vector<int32_t>  _ditherValues;
+
+        // the feedback of the held sample decays by a factor of .25 per sample (see processChannel())
+
+        std::vector<float> _feedbackDecay;
+
+        static constexpr uint32_t DITHER_MULTIPLIER = 1664525u;
+        static constexpr uint32_t DITHER_INCREMENT  = 1013904223u;
+        static constexpr int DITHER_LANES = 8; // amount of noise generator states advanced in parallel
+
+        inline int32_t nextDitherValue( uint32_t& seed ) {
+            seed = seed * DITHER_MULTIPLIER + DITHER_INCREMENT;
+            return ( int32_t )( seed >> 1 );
+        }
+
+        // the noise generator states for each sample of the current process cycle (per channel), where
+        // the first entry holds the last value of the previous cycle (see generateDither())
+
+        std::vector<std::vector<uint32_t>> _ditherBuffers;
+
+        // generates the noise generator states for given bufferSize for given channel, and
+        // returns them (updating the channels generator state to the end of the buffer)
+
+        const uint32_t* generateDither( int channel, int bufferSize );
+
+        // the difference between the noise value of given sample and the one preceding it
+
+        template <typename SampleType>
+        inline SampleType ditherDelta( const uint32_t* seeds, int sample ) {
+            return ( SampleType )(( int32_t )( seeds[ sample + 1 ] >> 1 ) - ( int32_t )( seeds[ sample ] >> 1 ));
+        }
 
         // clock speed
 
@@ -139,6 +388,11 @@ class PluginProcess
         LFO* _downSampleLfo;
         LFO* _playbackRateLfo;
 
+        // the oscillator values for each sample of the current process cycle
+
+        std::vector<float> _downSampleLfoValues;
+        std::vector<float> _playbackRateLfoValues;
+
         bool  _hasDownSampleLfo;
         float _downSampleLfoDepth;
         float _downSampleLfoRange;
@@ -160,12 +414,70 @@ class PluginProcess
         void setActualDownSampling( float value );
         void setActualPlaybackRate( float value );
 
+        // the rates scheduled for the current process cycle (see scheduleRates())
+
+        struct RateChange {
+            int offset;
+            float resampleRate;
+            float playbackRate;
+        };
+        std::vector<RateChange> _rateChanges;
+        int _appliedRateChanges = 0;
+
+        // applies the rates scheduled up until given offset, where readPointer is the read position
+        // of the read segments being calculated (which is synced when down sampling is deactivated)
+
+        void applyScheduledRates( int offset, float& readPointer );
+
+        // calculates the read segments for the current process cycle (running the oscillators
+        // and advancing the read pointer), returns the amount of segments for given bufferSize
+
+        int calculateReadSegments( int bufferSize );
+
+        // reads the sample for each read segment from the record buffer and applies
+        // the lowpass filter onto it (for all channels at once)
+
+        template <typename SampleType>
+        void filterReadSegments( int amountOfSegments, int numChannels, int bufferSize );
+
+        // the position of the write pointer once given bufferSize has been recorded
+
+        int getNextWritePointer( int bufferSize );
+
+        // the record buffer index at which given sample of the current process cycle is written
+
+        int getWriteIndex( int sample );
+
+        // the delay (in samples) of the signal when down sampling cleanly
+
+        int getCleanDelay();
+
+        // applies the effects onto given channel, writing the result into the same channel of the outBuffer
+
+        template <typename SampleType>
+        void processChannel( int c, SampleType** inBuffer, SampleType** outBuffer, int bufferSize, int amountOfSegments );
+
         // ensures the pre- and post mix buffers match the appropriate amount of channels
         // and buffer size. this also clones the contents of given in buffer into the pre-mix buffer
         // the buffers are pooled so this can be called upon each process cycle without allocation overhead
 
         template <typename SampleType>
         void prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize );
+
+        // restores the recording loaded into the recordingStore (if any) into the record buffer, preceding
+        // the current write pointer. Long recordings are restored over multiple process cycles to keep the
+        // duration of each cycle bounded. The range the read pointer plays back is restored first (from the
+        // read pointer onwards), after which the remaining history is restored (most recent samples first)
+
+        template <typename SampleType>
+        void restoreRecording( int bufferSize );
+
+        RecordingStore::Recording* _restoringRecording = nullptr;
+        std::vector<float*> _restoreChannels;
+        int _restoreIndex   = 0; // record buffer index the restored recording precedes
+        int _restoreLength  = 0;
+        int _restoredLength = 0;
+        int _playbackLength = 0; // the amount of most recent samples spanning the read pointer (restored first)
 };
 }
 
@@ -21,9 +21,20 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <algorithm>
+#include <limits>
 
 namespace Igorski
 {
+template <>
+inline PluginProcess::SignalPath<float>& PluginProcess::getSignalPath<float>() {
+    return _floatPath;
+}
+
+template <>
+inline PluginProcess::SignalPath<double>& PluginProcess::getSignalPath<double>() {
+    return _doublePath;
+}
+
 template <typename SampleType>
 void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels,
                              int bufferSize, uint32 sampleFramesSize ) {
@@ -32,131 +43,373 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
         return; // Variable Block Size unit test
     }
 
-    // input and output buffers can be float or double as defined
-    // by the templates SampleType value. Internally we process
-    // audio as floats
+    // only process the channels the processor has been configured for (see setAmountOfChannels())
 
-    SampleType inSample;
-    int32 i, l;
+    int numChannels = std::min( _amountOfChannels, std::min( numInChannels, numOutChannels ));
+    SignalPath<SampleType>& path = getSignalPath<SampleType>();
 
-    bool mixDry = _dryMix != 0.f;
+    prepareMixBuffers( inBuffer, numChannels, bufferSize );
+    restoreRecording<SampleType>( bufferSize );
 
-    SampleType dryMix = ( SampleType ) _dryMix;
-    SampleType wetMix = ( SampleType ) _wetMix;
+    // note the input is written prior to processing as the host can provide the same buffers for in- and output
+
+    spectrumAnalyzer.writeInput<SampleType>( inBuffer, numChannels, bufferSize );
 
-    prepareMixBuffers( inBuffer, numInChannels, bufferSize );
+    // write input into the record buffer
 
-    float readPointer;
     int writePointer;
     int recordMax = _maxRecordBufferSize - 1; // never record beyond the record buffer size (duh...)
 
-    int t, t2;
-    float incr, frac, s1, s2;
+    for ( int32 c = 0; c < numChannels; ++c ) {
+        PROFILE_BEGIN( RECORD );
+
+        SampleType* channelInBuffer     = inBuffer[ c ];
+        SampleType* channelRecordBuffer = path.recordBuffer->getBufferForChannel( c );
+
+        writePointer = _writePointer;
+
+        for ( int32 i = 0; i < bufferSize; ++i, ++writePointer ) {
+            if ( writePointer > recordMax ) {
+                writePointer = 0;
+            }
+            channelRecordBuffer[ writePointer ] = channelInBuffer[ i ];
+        }
+        PROFILE_END( profiler, c, RECORD );
+    }
+    waveformOverview.write<SampleType>( inBuffer, numChannels, _writePointer, bufferSize );
+    recordingStore.write<SampleType>( inBuffer, numChannels, bufferSize );
 
-    int maxBufferPos  = bufferSize - 1;
-    int maxReadOffset = _writePointer + maxBufferPos; // never read beyond the range of the current incoming input
+    // the read range (and the oscillators moving it) is equal for all channels. Calculate the
+    // read segments and bit crusher resolution once so the channels only have to process audio
+    // (the cycles of these stages are attributed to the first channel)
 
-    float curSample, nextSample, outSample;
+    PROFILE_BEGIN( RESAMPLE );
+    int amountOfSegments = calculateReadSegments( bufferSize );
 
-    // cache oscillator positions (are reset for each channel where the last iteration is saved)
+    // read the samples for the current read range, applying the lowpass filter onto all channels at once
 
-    float downSampleLfoAcc   = _downSampleLfo->getAccumulator();
-    float playbackRateLfoAcc = _playbackRateLfo->getAccumulator();
-    float lfoValue;
+    filterReadSegments<SampleType>( amountOfSegments, numChannels, bufferSize );
+    PROFILE_END( profiler, 0, RESAMPLE );
 
-    // temp variables for dithering
+    PROFILE_BEGIN( BIT_CRUSH );
+    bitCrusher->prepare( bufferSize );
+    PROFILE_END( profiler, 0, BIT_CRUSH );
 
-    int r1 = 0;
-    int r2 = 0;
+    // as the channels are independent up until the limiter, these can be processed in parallel
+    // (when enabled, see setMultiThreaded()), the pool returns once all channels have been processed
 
-    for ( int32 c = 0; c < numInChannels; ++c )
-    {
-        readPointer  = _readPointer;
-        writePointer = _writePointer;
+    if ( _workerPool != nullptr && numChannels >= MIN_CHANNELS_PER_POOL ) {
+        ChannelTask<SampleType> task = { this, inBuffer, outBuffer, bufferSize, amountOfSegments };
+        _workerPool->run( &ChannelTask<SampleType>::run, &task, numChannels );
+    } else {
+        for ( int32 c = 0; c < numChannels; ++c ) {
+            processChannel<SampleType>( c, inBuffer, outBuffer, bufferSize, amountOfSegments );
+        }
+    }
 
-        SampleType* channelInBuffer  = inBuffer[ c ];
-        SampleType* channelOutBuffer = outBuffer[ c ];
-        float* channelRecordBuffer   = _recordBuffer->getBufferForChannel( c );
-        float* channelPreMixBuffer   = _preMixBuffer->getBufferForChannel( c );
+    // update write index (read index has been updated by calculateReadSegments())
+    _writePointer = getNextWritePointer( bufferSize );
 
-        LowPassFilter* lowPassFilter = _lowPassFilters.at( c );
+    // limit the output signal in case its gets hot (e.g. on heavy bit reduction)
 
-        _downSampleLfo->setAccumulator( downSampleLfoAcc );
-        _playbackRateLfo->setAccumulator( playbackRateLfoAcc );
+    PROFILE_BEGIN( LIMITER );
 
-        float lastSample = _lastSamples[ c ];
+    if ( _oversampling == 1 ) {
+        limiter->process<SampleType>( outBuffer, bufferSize, numChannels );
+    } else {
+        // when oversampling, the limiter is applied onto the oversampled signal, which
+        // is subsequently downsampled into the output buffer
 
-        // write input into the record buffer (converting to float when necessary)
+        limiter->process<SampleType>( path.oversampledChannels.data(), bufferSize * _oversampling, numChannels );
 
-        for ( i = 0; i < bufferSize; ++i, ++writePointer ) {
-            if ( writePointer > recordMax ) {
-                writePointer = 0;
+        for ( int32 c = 0; c < numChannels; ++c ) {
+            path.downsamplers[ c ].downsample( path.oversampledChannels[ c ], outBuffer[ c ], bufferSize );
+        }
+    }
+    PROFILE_END( profiler, 0, LIMITER );
+    PROFILE_COMMIT( profiler );
+
+    float readPosition = getReadPosition();
+    int writeIndex     = getWriteIndex( 0 );
+    float readLag      = ( float ) writeIndex - readPosition;
+
+    waveformOverview.publish( readPosition, _writePointer );
+    recordingStore.setReadPosition( readPosition, writeIndex, readLag < 0.f ? readLag + ( float ) _maxRecordBufferSize : readLag );
+    spectrumAnalyzer.writeOutput<SampleType>( outBuffer, numChannels, bufferSize );
+}
+
+template <typename SampleType>
+void PluginProcess::filterReadSegments( int amountOfSegments, int numChannels, int bufferSize )
+{
+    SignalPath<SampleType>& path = getSignalPath<SampleType>();
+    AudioBuffer<SampleType>* recordBuffer = path.recordBuffer;
+
+    int stride        = path.lowPassFilterBank->getStride();
+    SampleType* frame = path.filteredSamples.data();
+
+    if ( _cleanDownSampling ) {
+        // the delay of the (linear phase) filter kernel grows with the decimation ratio. The kernel is read
+        // at an older position for the lower ratios, so the delay is constant (and reported as latency)
+
+        int cleanDelay = getCleanDelay();
+
+        for ( int s = 0; s < amountOfSegments; ++s, frame += stride ) {
+            const ReadSegment& segment = _readSegments[ s ];
+
+            if ( segment.offset > 0 ) {
+                continue; // continued segments hold the sample read in the previous process cycle
+            }
+
+            int readOffset = segment.readOffset - ( cleanDelay - _decimationFilter->getDelay( segment.sampleIncr ));
+            if ( readOffset < 0 ) {
+                readOffset += _maxRecordBufferSize;
+            }
+
+            for ( int c = 0; c < numChannels; ++c ) {
+                frame[ c ] = _decimationFilter->apply(
+                    recordBuffer->getBufferForChannel( c ), _maxRecordBufferSize, readOffset, segment.sampleIncr
+                );
             }
-            channelRecordBuffer[ writePointer ] = ( float ) channelInBuffer[ i ];
         }
+        return;
+    }
 
-        // write current read range into the premix buffer, downsampling as necessary
+    if ( _interpolator->getQuality() == Interpolator::HOLD ) {
+        for ( int s = 0; s < amountOfSegments; ++s, frame += stride ) {
+            int readOffset = _readSegments[ s ].readOffset;
 
-        i = 0;
+            for ( int c = 0; c < numChannels; ++c ) {
+                frame[ c ] = recordBuffer->getBufferForChannel( c )[ readOffset ];
+            }
+        }
+    } else {
+        // the read positions are equal for all channels, calculate the interpolation weights once
+        // the most recently recorded sample lies just before the write pointer of the next cycle
 
-        while ( i < bufferSize ) {
-            t  = ( int ) readPointer;
-            t2 = std::min( recordMax, t + _sampleIncr );
+        int newestIndex = getNextWritePointer( bufferSize ) - 1;
 
-            // this fractional is in the 0 - 1 range
-            // NOTE: we have uncommented this calculation
-            // as the result is devilishly tasty when down sampling
+        _interpolator->prepare( amountOfSegments, _maxRecordBufferSize, newestIndex );
 
-            frac = /*readPointer - t :*/ 0.f;
+        for ( int s = 0; s < amountOfSegments; ++s ) {
+            const ReadSegment& segment = _readSegments[ s ];
 
-            s1 = channelRecordBuffer[ t ];
-            s2 = channelRecordBuffer[ t2 ];
+            // in deterministic mode, only the samples recorded up until the start of the segment can
+            // be read (as the amount of samples recorded beyond it depends on the buffer size)
 
-            // we apply a lowpass filter to prevent interpolation artefacts
+            if ( _deterministic ) {
+                _interpolator->setNewestIndex( getWriteIndex( segment.start ));
+            }
+            _interpolator->setPosition( s, segment.readOffset, segment.fraction );
+        }
+
+        SampleType* interpolatedSamples = path.interpolatedSamples.data();
+
+        for ( int c = 0; c < numChannels; ++c ) {
+            _interpolator->apply( recordBuffer->getBufferForChannel( c ), interpolatedSamples );
 
-            curSample = lowPassFilter->applySingle( s1 + ( s2 - s1 ) * frac );
-            outSample = curSample * .5f;
+            for ( int s = 0; s < amountOfSegments; ++s ) {
+                frame[ s * stride + c ] = interpolatedSamples[ s ];
+            }
+        }
+    }
 
-            int start = i;
-            for ( l = std::min( bufferSize, start + _sampleIncr ); i < l; ++i ) {
-                r2 = r1;
-                r1 = rand();
+    frame = path.filteredSamples.data();
 
-                nextSample = outSample + lastSample;
+    for ( int s = 0; s < amountOfSegments; ++s, frame += stride ) {
+        const ReadSegment& segment = _readSegments[ s ];
+
+        // continued segments have been filtered in the previous process cycle
+
+        if ( segment.offset == 0 ) {
+            path.lowPassFilterBank->setRatio( segment.filterRatio );
+            path.lowPassFilterBank->applyFrame( frame );
+        }
+    }
+}
+
+template <typename SampleType>
+void PluginProcess::processChannel( int c, SampleType** inBuffer, SampleType** outBuffer, int bufferSize, int amountOfSegments )
+{
+    // input and output buffers can be float or double as defined
+    // by the templates SampleType value. Internally we process
+    // audio at the same precision (see SignalPath)
+
+    SampleType inSample;
+    int32 i, l, s, k;
+
+    bool mixDry = _dryMix != 0.f;
+
+    SampleType dryMix = ( SampleType ) _dryMix;
+    SampleType wetMix = ( SampleType ) _wetMix;
+
+    SampleType nextSample, outSample;
+
+    SignalPath<SampleType>& path = getSignalPath<SampleType>();
+
+    SampleType* channelDryBuffer    = inBuffer[ c ];
+    SampleType* channelOutBuffer    = outBuffer[ c ];
+    SampleType* channelPreMixBuffer = path.preMixBuffer->getBufferForChannel( c );
+    SampleType* filteredSamples     = path.filteredSamples.data() + c;
+    int stride                      = path.lowPassFilterBank->getStride();
+
+    SampleType lastSample = path.lastSamples[ c ];
+
+    // the dither noise for the entire buffer is generated upfront (each channel has its own noise
+    // generator so channels can be processed in any order), see generateDither()
+
+    const uint32_t* ditherSeeds = generateDither( c, bufferSize );
+    const SampleType ditherOffset    = DITHER_DC_OFFSET;
+    const SampleType ditherAmplitude = DITHER_AMPLITUDE;
+    const float* feedbackDecay       = _feedbackDecay.data();
+    const SampleType oneThird        = ( SampleType ) 1 / ( SampleType ) 3;
+
+    // write current read range into the premix buffer, downsampling as necessary
+
+    PROFILE_BEGIN( RESAMPLE );
+
+    bool singleSampleSegments = amountOfSegments == bufferSize &&
+                                _readSegments[ 0 ].offset == 0 && _readSegments[ amountOfSegments - 1 ].finished;
+
+    if ( singleSampleSegments )
+    {
+        // no down sampling is applied (e.g. each segment spans a single sample), mix the samples with their predecessor directly
+
+        for ( i = 0; i < bufferSize; ++i ) {
+            nextSample = filteredSamples[ i * stride ] * .5f + lastSample;
+            lastSample = nextSample * .25f;
+
+            // write sample into the output buffer, corrected for DC offset and dithering applied
+            channelPreMixBuffer[ i ] = nextSample + ditherOffset + ditherAmplitude * ditherDelta<SampleType>( ditherSeeds, i );
+
+            // catch denormals
+            UNDENORMALISE( channelPreMixBuffer[ i ]);
+        }
+    }
+    else
+    {
+        for ( s = 0; s < amountOfSegments; ++s ) {
+            const ReadSegment& segment = _readSegments[ s ];
+
+            // in deterministic mode, single sample segments are mixed directly (as above) so the
+            // result doesn't depend on how the segments are distributed over the process cycles
+
+            if ( _deterministic && segment.finished && segment.offset == 0 && segment.end - segment.start == 1 ) {
+                i = segment.start;
+
+                nextSample = filteredSamples[ s * stride ] * .5f + lastSample;
                 lastSample = nextSample * .25f;
 
+                channelPreMixBuffer[ i ] = nextSample + ditherOffset + ditherAmplitude * ditherDelta<SampleType>( ditherSeeds, i );
+                UNDENORMALISE( channelPreMixBuffer[ i ]);
+                continue;
+            }
+
+            SampleType convergedSample, decay, heldSample;
+
+            if ( segment.offset > 0 ) {
+                // continue the held sample of the segment started in the previous process cycle
+
+                const auto& unfinishedSegment = path.unfinishedSegments[ c ];
+
+                convergedSample = unfinishedSegment.convergedSample;
+                decay           = unfinishedSegment.decay;
+                heldSample      = unfinishedSegment.heldSample;
+            } else {
+                // NOTE: by default we do not interpolate between the current and next read offset (e.g. no fractional
+                // is applied) as the result is devilishly tasty when down sampling
+                // the samples have been lowpass filtered to prevent interpolation artefacts (see filterReadSegments())
+
+                outSample = filteredSamples[ s * stride ] * .5f;
+
+                // each sample is mixed with a quarter of the previous sample (lastSample), this feedback converges
+                // geometrically onto a third of the held sample. As such each sample of the segment can be calculated
+                // directly (see _feedbackDecay) allowing the held segment to be written using vector instructions
+
+                convergedSample = outSample * oneThird;
+                decay           = lastSample - convergedSample;
+                heldSample      = outSample + convergedSample + ditherOffset;
+            }
+
+            for ( i = segment.start, l = segment.end, k = segment.offset; i < l; ++i, ++k ) {
                 // write sample into the output buffer, corrected for DC offset and dithering applied
-                channelPreMixBuffer[ i ] = nextSample + DITHER_DC_OFFSET + DITHER_AMPLITUDE * ( float )( r1 - r2 );
+                channelPreMixBuffer[ i ] = heldSample + decay * feedbackDecay[ k ] + ditherAmplitude * ditherDelta<SampleType>( ditherSeeds, i );
 
                 // catch denormals
                 UNDENORMALISE( channelPreMixBuffer[ i ]);
+            }
+
+            if ( segment.finished ) {
+                lastSample = convergedSample + decay * feedbackDecay[ k ];
+            } else {
+                path.unfinishedSegments[ c ] = { heldSample, convergedSample, decay };
+            }
+        }
+    }
 
-                // run the oscillators, note we multiply by .5 and add .5 to make the LFO's bipolar waveforms unipolar
+    // when down sampling cleanly the wet signal is delayed (see filterReadSegments()), the dry signal is
+    // delayed by the same amount by reading it from the record buffer (which holds the recent input)
 
-                if ( _hasDownSampleLfo ) {
-                    lfoValue = _downSampleLfo->peek() * .5f + .5f;
-                    setActualDownSampling( std::min( _downSampleLfoMax, _downSampleLfoMin + _downSampleLfoRange * lfoValue ) * _maxDownSample );
-                    l = std::min( bufferSize, start + _sampleIncr );
-                }
+    if ( _cleanDownSampling && mixDry ) {
+        const SampleType* channelRecordBuffer = path.recordBuffer->getBufferForChannel( c );
+        channelDryBuffer = path.dryBuffer->getBufferForChannel( c );
 
-                if ( _hasPlaybackRateLfo ) {
-                    lfoValue = _playbackRateLfo->peek() * .5f + .5f;
-                    setActualPlaybackRate( std::min( _playbackRateLfoMax, _playbackRateLfoMin + _playbackRateLfoRange * lfoValue ));
-                }
+        int readIndex = getWriteIndex( 0 ) - getCleanDelay();
+        if ( readIndex < 0 ) {
+            readIndex += _maxRecordBufferSize;
+        }
+        for ( i = 0; i < bufferSize; ++i, ++readIndex ) {
+            if ( readIndex == _maxRecordBufferSize ) {
+                readIndex = 0;
             }
+            channelDryBuffer[ i ] = channelRecordBuffer[ readIndex ];
+        }
+    }
 
-            // note we cannot cache the increment value as its parts are altered by the oscillators in the render cycle above
-            incr = _fSampleIncr * _actualPlaybackRate;
+    PROFILE_END( profiler, c, RESAMPLE );
+    PROFILE_BEGIN( BIT_CRUSH );
 
-            if (( readPointer += incr ) > maxReadOffset ) {
-                readPointer = ( float ) writePointer; // don't go to 0.f but align with last write offset to play "current audio"
-            }
+    if ( _oversampling > 1 )
+    {
+        // apply the bit crusher onto the upsampled signal and mix the (upsampled) input signal at the
+        // higher sample rate (the dry signal is upsampled too so both signals share the same latency)
+        // the result is limited and downsampled into the output buffer once all channels have been processed
+
+        int oversampledSize = bufferSize * _oversampling;
+        SampleType* channelOversampledBuffer = path.oversampledChannels[ c ];
+
+        path.wetUpsamplers[ c ].upsample( channelPreMixBuffer, channelOversampledBuffer, bufferSize );
+        bitCrusher->process( channelOversampledBuffer, oversampledSize, _oversampling );
+
+        PROFILE_END( profiler, c, BIT_CRUSH );
+        PROFILE_BEGIN( MIX );
+
+        for ( i = 0; i < oversampledSize; ++i ) {
+            channelOversampledBuffer[ i ] = Calc::capSample( channelOversampledBuffer[ i ] * wetMix );
         }
 
+        if ( mixDry ) {
+            SampleType* channelOversampledDryBuffer = path.oversampledDryBuffer->getBufferForChannel( c );
+
+            // the output buffer is only written after all channels have been processed, as such
+            // the input can be read directly (even when the host provides the same buffer for both)
+
+            path.dryUpsamplers[ c ].upsample( channelDryBuffer, channelOversampledDryBuffer, bufferSize );
+
+            for ( i = 0; i < oversampledSize; ++i ) {
+                channelOversampledBuffer[ i ] += channelOversampledDryBuffer[ i ] * dryMix;
+            }
+        }
+        PROFILE_END( profiler, c, MIX );
+    }
+    else
+    {
         // apply bit crusher
 
         bitCrusher->process( channelPreMixBuffer, bufferSize );
 
+        PROFILE_END( profiler, c, BIT_CRUSH );
+        PROFILE_BEGIN( MIX );
+
         // mix the input and processed mix buffers into the output buffer
 
         for ( i = 0; i < bufferSize; ++i ) {
@@ -164,11 +417,11 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
             // before writing to the out buffer we take a snapshot of the current in sample
             // value as VST2 in Ableton Live supplies the same buffer for inBuffer and outBuffer!
 
-            inSample = channelInBuffer[ i ];
+            inSample = channelDryBuffer[ i ];
 
             // wet mix (e.g. the effected signal)
 
-            channelOutBuffer[ i ] = Calc::capSample(( SampleType ) channelPreMixBuffer[ i ] * wetMix );
+            channelOutBuffer[ i ] = Calc::capSample( channelPreMixBuffer[ i ] * wetMix );
 
             // dry mix (e.g. mix in the input signal)
 
@@ -176,47 +429,273 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
                 channelOutBuffer[ i ] += ( inSample * dryMix );
             }
         }
-        // update channel properties
-        _lastSamples[ c ] = lastSample;
+        PROFILE_END( profiler, c, MIX );
     }
-    // update read/write indices
-    _readPointer  = readPointer;
-    _writePointer = writePointer;
-
-    // limit the output signal in case its gets hot (e.g. on heavy bit reduction)
-    limiter->process<SampleType>( outBuffer, bufferSize, numOutChannels );
+    // update channel properties (the dither state has been updated by generateDither())
+    path.lastSamples[ c ] = lastSample;
 }
 
 template <typename SampleType>
 void PluginProcess::prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize )
 {
+    SignalPath<SampleType>& path = getSignalPath<SampleType>();
+
     // variable block size for a smaller block should not require new record buffers
     // only create these when the last size was smaller than the current
-    if ( bufferSize <= _lastBufferSize ) {
+    if ( bufferSize <= path.lastBufferSize ) {
+        _maxRecordBufferSize = path.recordBuffer->bufferSize; // in case the host switched sample types
         return;
     }
 
-    _lastBufferSize = bufferSize;
+    path.lastBufferSize = bufferSize;
+
+    // the state shared by both signal paths only grows
+
+    if ( bufferSize > _lastBufferSize ) {
+        _lastBufferSize = bufferSize;
+
+        // the read segments are at most as long as the buffer (e.g. when no down sampling is applied)
+
+        _readSegments.resize( bufferSize );
+
+        // (sized regardless of the current quality, so the quality can be changed without allocating)
+
+        _interpolator->reserve( bufferSize );
+
+        _downSampleLfoValues.resize( bufferSize );
+        _playbackRateLfoValues.resize( bufferSize );
+
+        // the feedback decay for each position within a read segment (which span at most bufferSize samples within
+        // a process cycle, though in deterministic mode a segment continued across process cycles can span up to the
+        // maximum down sampling amount). The values are powers of two (and thus exact) where values in the denormal
+        // range are flushed to zero
+
+        int maxSegmentLength = std::max( bufferSize, ( int ) ceil( _maxDownSample ));
+
+        _feedbackDecay.resize( maxSegmentLength + 1 );
+        for ( int i = 0; i <= maxSegmentLength; ++i ) {
+            float decay = ldexp( 1.f, -2 * i );
+            _feedbackDecay[ i ] = decay < std::numeric_limits<float>::min() ? 0.f : decay;
+        }
+
+        // the dither buffers are padded to a multiple of the dither lanes (see generateDither())
+
+        int ditherSize = ( bufferSize + DITHER_LANES - 1 ) / DITHER_LANES * DITHER_LANES + 1;
+        _ditherBuffers.resize( _amountOfChannels );
+        for ( auto& ditherBuffer : _ditherBuffers ) {
+            ditherBuffer.resize( ditherSize );
+        }
+    }
+    path.filteredSamples.assign( bufferSize * path.lowPassFilterBank->getStride(), ( SampleType ) 0 );
+    path.interpolatedSamples.assign( bufferSize, ( SampleType ) 0 );
 
     // if the record buffer wasn't created yet or the buffer size has changed
     // delete existing buffer and create new one to match properties
 
+    // in deterministic mode the record size is fixed, as otherwise the moment at which the buffer wraps depends on the buffer size
+
     int idealRecordSize = Calc::secondsToBuffer( MAX_RECORD_SECONDS );
-    int recordSize      = idealRecordSize + idealRecordSize % bufferSize;
+    int recordSize      = _deterministic ? idealRecordSize : idealRecordSize + idealRecordSize % bufferSize;
 
-    if ( _recordBuffer == nullptr || _recordBuffer->bufferSize != recordSize ) {
-        delete _recordBuffer;
-        _recordBuffer = new AudioBuffer( numInChannels, recordSize );
-        _maxRecordBufferSize = recordSize;
+    if ( path.recordBuffer == nullptr || path.recordBuffer->bufferSize != recordSize ) {
+        delete path.recordBuffer;
+        path.recordBuffer = new AudioBuffer<SampleType>( numInChannels, recordSize );
     }
+    _maxRecordBufferSize = recordSize;
+    waveformOverview.prepare( recordSize );
 
     // if the pre mix buffer wasn't created yet or the buffer size has changed
     // delete existing buffer and create new one to match properties
 
-    if ( _preMixBuffer == nullptr || _preMixBuffer->bufferSize != bufferSize ) {
-        delete _preMixBuffer;
-        _preMixBuffer = new AudioBuffer( numInChannels, bufferSize );
+    if ( path.preMixBuffer == nullptr || path.preMixBuffer->bufferSize != bufferSize ) {
+        delete path.preMixBuffer;
+        delete path.dryBuffer;
+        path.preMixBuffer = new AudioBuffer<SampleType>( numInChannels, bufferSize );
+        path.dryBuffer    = new AudioBuffer<SampleType>( numInChannels, bufferSize );
+    }
+
+    path.prepareOversampledBuffers( _amountOfChannels, bufferSize, _oversampling );
+}
+
+template <typename SampleType>
+void PluginProcess::restoreRecording( int bufferSize )
+{
+    if ( _restoringRecording == nullptr ) {
+        _restoringRecording = recordingStore.beginRestore();
+
+        if ( _restoringRecording == nullptr ) {
+            return;
+        }
+
+        // recordings made at a different sample rate or channel configuration are not restored
+
+        if ( _restoringRecording->amountOfChannels != _amountOfChannels || _restoringRecording->sampleRate != VST::SAMPLE_RATE ) {
+            recordingStore.endRestore();
+            _restoringRecording = nullptr;
+            return;
+        }
+        _restoreLength  = std::min( _restoringRecording->length, _maxRecordBufferSize - bufferSize );
+        _restoredLength = 0;
+
+        // position the read pointer relative to the write pointer, as it was when the recording was saved
+
+        float readLag = std::min( _restoringRecording->readLag, ( float ) _restoreLength );
+
+        // the read pointer accumulates a rounding error that depends on its position within the record buffer, as
+        // such the recording is restored at the position it was saved at (when this position fits the record buffer)
+
+        float readPosition = _restoringRecording->readPosition;
+        int writeIndex     = _restoringRecording->writeIndex;
+
+        bool restorePosition = !_deterministic && readPosition >= 0.f && readPosition <= ( float ) writeIndex &&
+                               writeIndex < _maxRecordBufferSize - bufferSize && ( float ) writeIndex - readPosition <= readLag;
+
+        if ( restorePosition ) {
+            _writePointer = writeIndex;
+        } else if ( !_deterministic && _writePointer < _restoreLength ) {
+            // a read pointer beyond the write pointer is considered to have overtaken it (see calculateReadSegments())
+            // so the recording is restored at the start of the record buffer, rather than wrapping around its end
+            _writePointer = _restoreLength;
+        }
+        _restoreIndex = getWriteIndex( 0 );
+
+        // the read pointer should be able to play back the recording right away, including the history
+        // required by the decimation filter and interpolator (see maxReadLag in calculateReadSegments())
+
+        int readHistory = DecimationFilter::TAPS_PER_RATIO * (( int ) _maxDownSample + 1 ) + Interpolator::MAX_TAPS;
+        _playbackLength = std::min( _restoreLength, ( int ) ceil( readLag ) + readHistory );
+
+        if ( _deterministic ) {
+            _readLag = readLag;
+        } else {
+            _readPointer = restorePosition ? readPosition : ( float ) _restoreIndex - readLag;
+            if ( _readPointer < 0.f ) {
+                _readPointer += ( float ) _maxRecordBufferSize;
+            }
+        }
+    }
+    RecordingStore::Recording& recording = *_restoringRecording;
+    AudioBuffer<SampleType>* recordBuffer = getSignalPath<SampleType>().recordBuffer;
+
+    // the restore should keep up with the read pointer, which advances by at most a sample per sample
+
+    int numChannels = std::min( recording.amountOfChannels, recordBuffer->amountOfChannels );
+    int blockSize   = std::max( RecordingStore::RESTORE_BLOCK_SIZE, bufferSize );
+    int length, offset; // within the recording
+
+    if ( _restoredLength < _playbackLength ) {
+        // the range played back by the read pointer, restored from the oldest sample onwards
+        length = std::min( blockSize, _playbackLength - _restoredLength );
+        offset = recording.length - _playbackLength + _restoredLength;
+    } else {
+        // the remaining history, restored from the most recent sample backwards
+        length = std::min( blockSize, _restoreLength - _restoredLength );
+        offset = recording.length - _restoredLength - length;
+    }
+
+    int writeIndex = _restoreIndex - ( recording.length - offset );
+    if ( writeIndex < 0 ) {
+        writeIndex += _maxRecordBufferSize;
+    }
+
+    for ( int c = 0; c < numChannels; ++c ) {
+        const float* samples = recording.getChannel( c ) + offset;
+        SampleType* channelRecordBuffer = recordBuffer->getBufferForChannel( c );
+
+        for ( int i = 0, w = writeIndex; i < length; ++i, ++w ) {
+            if ( w == _maxRecordBufferSize ) {
+                w = 0;
+            }
+            channelRecordBuffer[ w ] = ( SampleType ) samples[ i ];
+        }
+        _restoreChannels[ c ] = recording.getChannel( c ) + offset;
+    }
+    waveformOverview.write<float>( _restoreChannels.data(), numChannels, writeIndex, length );
+    recordingStore.writeRestored( recording, offset, length );
+
+    _restoredLength += length;
+
+    if ( _restoredLength >= _restoreLength ) {
+        recordingStore.endRestore();
+        _restoringRecording = nullptr;
+    }
+}
+
+/* signal path */
+
+template <typename SampleType>
+PluginProcess::SignalPath<SampleType>::~SignalPath()
+{
+    deleteBuffers();
+    delete lowPassFilterBank;
+}
+
+template <typename SampleType>
+void PluginProcess::SignalPath<SampleType>::setAmountOfChannels( int amountOfChannels, int oversampling )
+{
+    lastSamples.assign( amountOfChannels, ( SampleType ) 0 );
+    unfinishedSegments.assign( amountOfChannels, { 0, 0, 0 });
+
+    delete lowPassFilterBank;
+    lowPassFilterBank = new LowPassFilterBank<SampleType>( amountOfChannels );
+
+    createOversamplers( amountOfChannels, oversampling );
+    deleteBuffers();
+}
+
+template <typename SampleType>
+void PluginProcess::SignalPath<SampleType>::createOversamplers( int amountOfChannels, int oversampling )
+{
+    wetUpsamplers.assign( amountOfChannels, Oversampler<SampleType>( oversampling ));
+    dryUpsamplers.assign( amountOfChannels, Oversampler<SampleType>( oversampling ));
+    downsamplers.assign( amountOfChannels, Oversampler<SampleType>( oversampling ));
+}
+
+template <typename SampleType>
+void PluginProcess::SignalPath<SampleType>::prepareOversampledBuffers( int amountOfChannels, int bufferSize, int oversampling )
+{
+    if ( oversampling == 1 ) {
+        return;
     }
+
+    int oversampledSize = bufferSize * oversampling;
+
+    if ( oversampledBuffer == nullptr || oversampledBuffer->bufferSize != oversampledSize ) {
+        deleteOversampledBuffers();
+
+        oversampledBuffer    = new AudioBuffer<SampleType>( amountOfChannels, oversampledSize );
+        oversampledDryBuffer = new AudioBuffer<SampleType>( amountOfChannels, oversampledSize );
+
+        oversampledChannels.resize( amountOfChannels );
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            oversampledChannels[ c ] = oversampledBuffer->getBufferForChannel( c );
+        }
+    }
+}
+
+template <typename SampleType>
+void PluginProcess::SignalPath<SampleType>::deleteOversampledBuffers()
+{
+    delete oversampledBuffer;
+    delete oversampledDryBuffer;
+
+    oversampledBuffer    = nullptr;
+    oversampledDryBuffer = nullptr;
+}
+
+template <typename SampleType>
+void PluginProcess::SignalPath<SampleType>::deleteBuffers()
+{
+    delete recordBuffer;
+    delete preMixBuffer;
+    delete dryBuffer;
+
+    recordBuffer   = nullptr;
+    preMixBuffer   = nullptr;
+    dryBuffer      = nullptr;
+    lastBufferSize = 0;
+
+    deleteOversampledBuffers();
 }
 
 }
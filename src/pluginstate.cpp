@@ -0,0 +1,207 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "pluginstate.h"
+#include "byteorder.h"
+#include "paramids.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Steinberg;
+using namespace Igorski::ByteOrder;
+
+namespace Igorski {
+
+namespace {
+    // the state written by previous versions: the values of the first 11 parameters, followed
+    // by the bypass and (when saved after the addition of tempo synchronization) LFO sync flags
+
+    const uint32_t LEGACY_PARAMETERS = 11;
+    const uint32_t LEGACY_MIN_SIZE   = ( LEGACY_PARAMETERS + 1 ) * 4;
+    const uint32_t LEGACY_MAX_SIZE   = ( LEGACY_PARAMETERS + 2 ) * 4;
+}
+
+/* public methods */
+
+void PluginState::setParameter( uint32_t id, float value )
+{
+    for ( auto& parameter : _parameters ) {
+        if ( parameter.first == id ) {
+            parameter.second = value;
+            return;
+        }
+    }
+    _parameters.emplace_back( id, value );
+}
+
+bool PluginState::getParameter( uint32_t id, float& value ) const
+{
+    for ( const auto& parameter : _parameters ) {
+        if ( parameter.first == id ) {
+            value = parameter.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PluginState::setChunk( uint32_t id, std::vector<uint8_t>&& data )
+{
+    for ( auto& chunk : _chunks ) {
+        if ( chunk.first == id ) {
+            chunk.second = std::move( data );
+            return;
+        }
+    }
+    _chunks.emplace_back( id, std::move( data ));
+}
+
+const std::vector<uint8_t>* PluginState::getChunk( uint32_t id ) const
+{
+    for ( const auto& chunk : _chunks ) {
+        if ( chunk.first == id ) {
+            return &chunk.second;
+        }
+    }
+    return nullptr;
+}
+
+bool PluginState::read( IBStream* stream )
+{
+    uint8_t header[ HEADER_SIZE ];
+    int32 bytesRead = 0;
+
+    if ( stream->read( header, HEADER_SIZE, &bytesRead ) != kResultOk ) {
+        return false;
+    }
+
+    // states written by previous versions have no header (as the first value is a normalized
+    // parameter value, it can never equal the identifier), read the remainder in a single call
+
+    if ( bytesRead < ( int32 ) HEADER_SIZE || readUint32( header ) != IDENTIFIER ) {
+        uint8_t legacy[ LEGACY_MAX_SIZE ];
+        memcpy( legacy, header, bytesRead );
+
+        int32 remainderRead = 0;
+        if ( bytesRead == ( int32 ) HEADER_SIZE ) {
+            stream->read( legacy + HEADER_SIZE, LEGACY_MAX_SIZE - HEADER_SIZE, &remainderRead );
+        }
+        return parseLegacy( legacy, ( uint32_t ) ( bytesRead + remainderRead ));
+    }
+
+    // the version is only of interest when a future version changes the meaning of existing
+    // chunks, as new data is added as new chunks the payload is parsed regardless
+
+    uint32_t size = readUint32( header + 8 );
+    if ( size > MAX_SIZE ) {
+        return false;
+    }
+    std::vector<uint8_t> payload( size );
+
+    if ( size > 0 && ( stream->read( payload.data(), ( int32 ) size, &bytesRead ) != kResultOk || bytesRead != ( int32 ) size )) {
+        return false;
+    }
+    return parse( payload.data(), size );
+}
+
+bool PluginState::write( IBStream* stream ) const
+{
+    uint32_t parametersSize = 4 + ( uint32_t ) _parameters.size() * 8;
+    uint32_t payloadSize    = 8 + parametersSize;
+
+    for ( const auto& chunk : _chunks ) {
+        payloadSize += 8 + ( uint32_t ) chunk.second.size();
+    }
+
+    std::vector<uint8_t> data;
+    data.reserve( HEADER_SIZE + payloadSize );
+
+    writeUint32( data, IDENTIFIER );
+    writeUint32( data, VERSION );
+    writeUint32( data, payloadSize );
+
+    writeUint32( data, PARAMETERS_CHUNK );
+    writeUint32( data, parametersSize );
+    writeUint32( data, ( uint32_t ) _parameters.size());
+
+    for ( const auto& parameter : _parameters ) {
+        writeUint32( data, parameter.first );
+        writeFloat( data, parameter.second );
+    }
+
+    for ( const auto& chunk : _chunks ) {
+        writeUint32( data, chunk.first );
+        writeUint32( data, ( uint32_t ) chunk.second.size());
+        data.insert( data.end(), chunk.second.begin(), chunk.second.end());
+    }
+
+    int32 bytesWritten = 0;
+    return stream->write( data.data(), ( int32 ) data.size(), &bytesWritten ) == kResultOk && bytesWritten == ( int32 ) data.size();
+}
+
+/* private methods */
+
+bool PluginState::parse( const uint8_t* data, uint32_t size )
+{
+    uint32_t offset = 0;
+
+    while ( size - offset >= 8 ) {
+        uint32_t chunk     = readUint32( data + offset );
+        uint32_t chunkSize = readUint32( data + offset + 4 );
+        offset += 8;
+
+        if ( chunkSize > size - offset ) {
+            return false; // truncated
+        }
+        const uint8_t* chunkData = data + offset;
+
+        if ( chunk == PARAMETERS_CHUNK && chunkSize >= 4 ) {
+            uint32_t amount = std::min( readUint32( chunkData ), ( chunkSize - 4 ) / 8 );
+
+            for ( uint32_t i = 0; i < amount; ++i ) {
+                setParameter( readUint32( chunkData + 4 + i * 8 ), readFloat( chunkData + 8 + i * 8 ));
+            }
+        } else if ( chunk != PARAMETERS_CHUNK ) {
+            setChunk( chunk, std::vector<uint8_t>( chunkData, chunkData + chunkSize ));
+        }
+        offset += chunkSize;
+    }
+    return true;
+}
+
+bool PluginState::parseLegacy( const uint8_t* data, uint32_t size )
+{
+    if ( size < LEGACY_MIN_SIZE ) {
+        return false;
+    }
+    for ( uint32_t i = 0; i < LEGACY_PARAMETERS; ++i ) {
+        setParameter( i, readFloat( data + i * 4 ));
+    }
+    setParameter( kBypassId, ( int32_t ) readUint32( data + LEGACY_PARAMETERS * 4 ) > 0 ? 1.f : 0.f );
+
+    if ( size >= LEGACY_MAX_SIZE ) {
+        setParameter( kLfoSyncId, ( int32_t ) readUint32( data + ( LEGACY_PARAMETERS + 1 ) * 4 ) > 0 ? 1.f : 0.f );
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,80 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PLUGINSTATE_H_INCLUDED__
+#define __PLUGINSTATE_H_INCLUDED__
+
+#include "pluginterfaces/base/ibstream.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Igorski {
+/**
+ * PluginState (de)serializes the state of the plugin (shared between processor and controller).
+ *
+ * The state is a versioned, length prefixed blob which is read and written using a single stream
+ * call (after the header) and parsed from memory. The payload consists of chunks (identifier, size
+ * and data) where unknown chunks are skipped, and the parameters chunk lists the value for each
+ * parameter ID, so states remain readable by both older and newer versions of the plugin.
+ * The headerless state written by previous versions (a fixed sequence of values) is read as well.
+ *
+ * All values are stored in little endian byte order.
+ */
+class PluginState
+{
+    public:
+        static constexpr uint32_t IDENTIFIER  = 0x54534348; // "HCST"
+        static constexpr uint32_t VERSION     = 1;
+        static constexpr uint32_t HEADER_SIZE = 12;         // identifier, version and payload size
+        static constexpr uint32_t MAX_SIZE    = 1 << 28;    // sanity check against corrupted headers
+
+        static constexpr uint32_t PARAMETERS_CHUNK = 0x534d5250; // "PRMS"
+        static constexpr uint32_t RECORDING_CHUNK  = 0x44524352; // "RCRD" (optional, see RecordingStore)
+
+        // sets the value to store for given parameter ID
+
+        void setParameter( uint32_t id, float value );
+
+        // retrieves the stored value for given parameter ID into value, returning false when
+        // the state holds no value for the parameter (e.g. as it was saved by an older version)
+
+        bool getParameter( uint32_t id, float& value ) const;
+
+        // sets the data of an additional chunk, or retrieves it (nullptr when the state holds no such chunk)
+
+        void setChunk( uint32_t id, std::vector<uint8_t>&& data );
+        const std::vector<uint8_t>* getChunk( uint32_t id ) const;
+
+        bool read( Steinberg::IBStream* stream );
+        bool write( Steinberg::IBStream* stream ) const;
+
+    private:
+        std::vector<std::pair<uint32_t, float>> _parameters;
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> _chunks;
+
+        bool parse( const uint8_t* data, uint32_t size );
+        bool parseLegacy( const uint8_t* data, uint32_t size );
+};
+}
+
+#endif
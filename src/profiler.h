@@ -0,0 +1,279 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PROFILER_H_INCLUDED__
+#define __PROFILER_H_INCLUDED__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ))
+    #include <intrin.h>
+    #define PROFILER_TSC
+#elif defined( __x86_64__ ) || defined( __i386__ )
+    #include <x86intrin.h>
+    #define PROFILER_TSC
+#elif !defined( __aarch64__ )
+    #include <chrono>
+#endif
+
+/**
+ * The profiling macros record the amount of cycles spent in a stage of the signal path. These
+ * compile to nothing unless the HC_PROFILE option is enabled in CMake (e.g. cmake -DHC_PROFILE=ON)
+ *
+ * PROFILE_BEGIN( RECORD ); ... PROFILE_END( profiler, channel, RECORD );
+ */
+#ifdef HC_PROFILE
+#define PROFILE_BEGIN( stage ) const uint64_t profileStart##stage = Igorski::Profiler::now()
+#define PROFILE_END( profiler, channel, stage ) ( profiler ).add( channel, Igorski::Profiler::stage, Igorski::Profiler::now() - profileStart##stage )
+#define PROFILE_COMMIT( profiler ) ( profiler ).commit()
+#else
+#define PROFILE_BEGIN( stage )
+#define PROFILE_END( profiler, channel, stage )
+#define PROFILE_COMMIT( profiler )
+#endif
+
+namespace Igorski {
+/**
+ * A Profiler keeps the running statistics (min / mean / max and 99th percentile) of the
+ * amount of cycles spent in each stage of the signal path, per process cycle.
+ *
+ * The process thread and the worker threads add the cycles for the channels they
+ * process (each channel has its own counters) after which the process thread commits
+ * the sum of all channels once the process cycle completes (see commit()).
+ *
+ * The statistics can be read from any thread while processing, without locking (note the
+ * values of a single stage are not read atomically, so they can be a process cycle apart)
+ *
+ * On x86 the cycles are read from the time stamp counter, on ARM64 from the virtual
+ * timer (which ticks at a lower, fixed frequency) and on other platforms these are nanoseconds.
+ */
+class Profiler
+{
+    public:
+        enum Stage {
+            RECORD = 0, // writing the input into the record buffer
+            RESAMPLE,   // reading, filtering and holding the down sampled signal
+            BIT_CRUSH,  // bit reduction (including the oversampling of its input)
+            MIX,        // mixing of the dry and wet signals
+            LIMITER,    // limiting (including the down sampling of the oversampled output)
+            AMOUNT_OF_STAGES
+        };
+
+        struct Statistics {
+            uint64_t count; // amount of measured process cycles
+            uint64_t min;
+            uint64_t max;
+            double mean;
+            uint64_t p99;   // 99th percentile (the upper bound of the histogram bucket holding it, see getBucket())
+        };
+
+        // the statistics of all stages
+
+        struct Report {
+            Statistics stages[ AMOUNT_OF_STAGES ];
+        };
+
+        // messages exchanged with the controller when profiling, the controller requests
+        // the Report which is sent in response (likewise to the DeadlineMonitor statistics)
+
+        static constexpr const char* REQUEST_MESSAGE = "ProfilerReportRequest";
+        static constexpr const char* REPORT_MESSAGE  = "ProfilerReport";
+        static constexpr const char* REPORT_DATA     = "Report"; // binary attribute holding the Report
+
+        // resizes the per-channel counters (not during processing!)
+
+        void setAmountOfChannels( int amountOfChannels ) {
+            _channelCycles.assign( std::max( 1, amountOfChannels ), ChannelCycles());
+        }
+
+        static inline uint64_t now() {
+#if defined( PROFILER_TSC )
+            return __rdtsc();
+#elif defined( __aarch64__ )
+            uint64_t ticks;
+            asm volatile( "mrs %0, cntvct_el0" : "=r"( ticks ));
+            return ticks;
+#else
+            return ( uint64_t ) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count();
+#endif
+        }
+
+        // adds given amount of cycles spent in given stage for given channel to the current process cycle
+
+        inline void add( int channel, Stage stage, uint64_t cycles ) {
+            _channelCycles[ channel ].cycles[ stage ] += cycles;
+        }
+
+        // commits the cycles of the current process cycle (summed for all channels) to the statistics
+
+        void commit() {
+            if ( _resetRequested.exchange( false, std::memory_order_acquire )) {
+                for ( auto& stage : _stages ) {
+                    stage.reset();
+                }
+            }
+
+            for ( int s = 0; s < AMOUNT_OF_STAGES; ++s ) {
+                uint64_t cycles = 0;
+
+                for ( auto& channel : _channelCycles ) {
+                    cycles += channel.cycles[ s ];
+                    channel.cycles[ s ] = 0;
+                }
+                _stages[ s ].add( cycles );
+            }
+        }
+
+        // retrieves the statistics of given stage (can be invoked from any thread)
+
+        Statistics getStatistics( Stage stage ) const {
+            const StageStatistics& source = _stages[ stage ];
+            Statistics statistics;
+
+            statistics.count = source.count.load( std::memory_order_relaxed );
+            statistics.min   = statistics.count > 0 ? source.min.load( std::memory_order_relaxed ) : 0;
+            statistics.max   = source.max.load( std::memory_order_relaxed );
+            statistics.mean  = statistics.count > 0 ? ( double ) source.sum.load( std::memory_order_relaxed ) / ( double ) statistics.count : 0.0;
+            statistics.p99   = 0;
+
+            // walk the histogram up until the bucket containing the 99th percentile
+
+            uint64_t threshold = statistics.count - statistics.count / 100;
+            uint64_t total     = 0;
+
+            for ( int i = 0; i < HISTOGRAM_BUCKETS && statistics.count > 0; ++i ) {
+                total += source.histogram[ i ].load( std::memory_order_relaxed );
+                if ( total >= threshold ) {
+                    statistics.p99 = std::min( statistics.max, getBucketLimit( i ));
+                    break;
+                }
+            }
+            return statistics;
+        }
+
+        // retrieves the statistics of all stages (can be invoked from any thread)
+
+        Report getReport() const {
+            Report report;
+            for ( int s = 0; s < AMOUNT_OF_STAGES; ++s ) {
+                report.stages[ s ] = getStatistics(( Stage ) s );
+            }
+            return report;
+        }
+
+        // requests all statistics to be cleared upon the next commit (can be invoked from any thread)
+
+        void reset() {
+            _resetRequested.store( true, std::memory_order_release );
+        }
+
+        static const char* getStageName( Stage stage ) {
+            static const char* names[ AMOUNT_OF_STAGES ] = { "record", "resample", "bit crush", "mix", "limiter" };
+            return names[ stage ];
+        }
+
+    private:
+        // the histogram divides each power of two into four buckets (values below 8 have their own bucket)
+
+        static constexpr int HISTOGRAM_BUCKETS = 64 * 4;
+
+        static inline int getBucket( uint64_t value ) {
+            if ( value < 8 ) {
+                return ( int ) value;
+            }
+            int octave = 3;
+            while ( value >> ( octave + 1 )) {
+                ++octave;
+            }
+            return octave * 4 + ( int )(( value >> ( octave - 2 )) & 3 );
+        }
+
+        // the (exclusive) upper value of given bucket
+
+        static inline uint64_t getBucketLimit( int bucket ) {
+            if ( bucket < 8 ) {
+                return ( uint64_t ) bucket + 1;
+            }
+            int octave = bucket / 4;
+            uint64_t limit = ( uint64_t )( 4 + bucket % 4 + 1 ) << ( octave - 2 );
+            return limit == 0 ? UINT64_MAX : limit;
+        }
+
+        // the statistics are only written by the process thread, as such the values
+        // need not be atomically incremented (but are atomic so they can be read while processing)
+
+        struct StageStatistics {
+            std::atomic<uint64_t> count{ 0 };
+            std::atomic<uint64_t> sum{ 0 };
+            std::atomic<uint64_t> min{ UINT64_MAX };
+            std::atomic<uint64_t> max{ 0 };
+            std::atomic<uint32_t> histogram[ HISTOGRAM_BUCKETS ];
+
+            StageStatistics() {
+                reset();
+            }
+
+            void add( uint64_t cycles ) {
+                count.store( count.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+                sum.store( sum.load( std::memory_order_relaxed ) + cycles, std::memory_order_relaxed );
+
+                if ( cycles < min.load( std::memory_order_relaxed )) {
+                    min.store( cycles, std::memory_order_relaxed );
+                }
+                if ( cycles > max.load( std::memory_order_relaxed )) {
+                    max.store( cycles, std::memory_order_relaxed );
+                }
+                std::atomic<uint32_t>& bucket = histogram[ getBucket( cycles )];
+                bucket.store( bucket.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            }
+
+            void reset() {
+                count.store( 0, std::memory_order_relaxed );
+                sum.store( 0, std::memory_order_relaxed );
+                min.store( UINT64_MAX, std::memory_order_relaxed );
+                max.store( 0, std::memory_order_relaxed );
+
+                for ( auto& bucket : histogram ) {
+                    bucket.store( 0, std::memory_order_relaxed );
+                }
+            }
+        };
+
+        // the cycles of the current process cycle, per channel (padded to prevent
+        // false sharing as the channels can be processed by different threads)
+
+        struct alignas( 64 ) ChannelCycles {
+            uint64_t cycles[ AMOUNT_OF_STAGES ] = { 0 };
+        };
+
+        StageStatistics _stages[ AMOUNT_OF_STAGES ];
+        std::vector<ChannelCycles> _channelCycles = std::vector<ChannelCycles>( 1 );
+        std::atomic<bool> _resetRequested{ false };
+};
+}
+
+#endif
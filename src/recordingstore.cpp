@@ -0,0 +1,460 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "recordingstore.h"
+#include "byteorder.h"
+#include <cmath>
+#include <cstring>
+
+using namespace Igorski::ByteOrder;
+
+namespace Igorski {
+
+namespace {
+    const uint32_t FORMAT_VERSION = 1;
+    const uint32_t HEADER_SIZE    = 28;      // version, sample rate, read lag, read position, write index, amount of channels and length
+    const uint64_t MAX_RAW_SIZE   = 1 << 28; // sanity check against corrupted data
+
+    // compression parameters (an LZ77 variant using the sequence layout of LZ4)
+
+    const int MIN_MATCH  = 4;
+    const int MAX_OFFSET = 65535;
+    const int HASH_BITS  = 14;
+}
+
+/* constructor / destructor */
+
+RecordingStore::RecordingStore()
+{
+
+}
+
+RecordingStore::~RecordingStore()
+{
+    delete _pendingRecording.exchange( nullptr );
+    delete _finishedRecording.exchange( nullptr );
+    delete _restoringRecording;
+    delete _retiredRecording;
+}
+
+/* public methods */
+
+void RecordingStore::prepare( int amountOfChannels, float seconds, float sampleRate )
+{
+    _amountOfChannels = amountOfChannels;
+    _sampleRate       = sampleRate;
+    _history          = ( int ) ( HISTORY_SECONDS * sampleRate );
+    _headroom         = ( int ) ( HEADROOM_SECONDS * sampleRate );
+    _size             = ( int ) ( seconds * sampleRate ) + _headroom;
+
+    size_t amountOfSamples = ( size_t ) _size * amountOfChannels;
+    _samples.reset( new std::atomic<int16_t>[ amountOfSamples ]);
+    for ( size_t i = 0; i < amountOfSamples; ++i ) {
+        _samples[ i ].store( 0, std::memory_order_relaxed );
+    }
+
+    // positions start at the size of the ring, so a restored recording can precede the first written sample
+
+    _position = ( uint64_t ) _size;
+    _written.store( _position, std::memory_order_relaxed );
+    _validFrom.store( _position, std::memory_order_relaxed );
+    _writing.store( _position, std::memory_order_relaxed );
+}
+
+void RecordingStore::setEnabled( bool enabled )
+{
+    _enabled.store( enabled, std::memory_order_relaxed );
+}
+
+bool RecordingStore::isEnabled()
+{
+    return _enabled.load( std::memory_order_relaxed );
+}
+
+void RecordingStore::setReadPosition( float readPosition, int writeIndex, float readLag )
+{
+    uint32_t readBits;
+    memcpy( &readBits, &readPosition, sizeof( float ));
+
+    _readLag.store( readLag, std::memory_order_relaxed );
+    _readWritePosition.store((( uint64_t ) ( uint32_t ) writeIndex << 32 ) | readBits, std::memory_order_relaxed );
+}
+
+bool RecordingStore::save( std::vector<uint8_t>& data )
+{
+    collectFinishedRecording();
+
+    if ( !isEnabled() || _size == 0 ) {
+        return false;
+    }
+    std::vector<int16_t> copy;
+    float readLag = 0.f;
+    uint64_t readWritePosition = 0;
+    int amount    = 0;
+    int skipped   = 0; // the amount of (oldest) samples in the copy that were overwritten while copying
+
+    for ( int attempt = 0; attempt < SAVE_ATTEMPTS && amount == 0; ++attempt ) {
+        uint32_t restores  = _restores.load( std::memory_order_acquire );
+        uint64_t written   = _written.load( std::memory_order_acquire );
+        uint64_t validFrom = _validFrom.load( std::memory_order_acquire );
+        readLag = _readLag.load( std::memory_order_relaxed );
+        readWritePosition = _readWritePosition.load( std::memory_order_relaxed );
+
+        // only the part of the recording that can still be played back is saved (the headroom
+        // makes it unlikely that the process thread overwrites the oldest samples while these are copied)
+
+        uint64_t length = written > validFrom ? written - validFrom : 0;
+        int wanted = ( int ) std::min( length, ( uint64_t ) std::min( _size - _headroom, ( int ) ceil( readLag ) + _history ));
+        if ( wanted <= 0 ) {
+            return false;
+        }
+        uint64_t start = written - wanted;
+        copy.resize(( size_t ) wanted * _amountOfChannels );
+
+        for ( int c = 0; c < _amountOfChannels; ++c ) {
+            const std::atomic<int16_t>* samples = _samples.get() + ( size_t ) c * _size;
+            int16_t* destination = copy.data() + ( size_t ) c * wanted;
+            int readIndex = ( int ) ( start % ( uint64_t ) _size );
+
+            for ( int i = 0; i < wanted; ++i, ++readIndex ) {
+                if ( readIndex == _size ) {
+                    readIndex = 0;
+                }
+                destination[ i ] = samples[ readIndex ].load( std::memory_order_relaxed );
+            }
+        }
+
+        // when the copy contains samples that were written after copying started, the process thread
+        // announced this (see write()) before writing these, the fence ensures the announcement is seen
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+
+        if ( _restores.load( std::memory_order_relaxed ) != restores ) {
+            continue; // a restore wrote into the copied range, copy again
+        }
+        uint64_t writing = _writing.load( std::memory_order_relaxed );
+        uint64_t oldest  = writing > ( uint64_t ) _size ? writing - _size : 0;
+
+        skipped = oldest > start ? ( int ) std::min( oldest - start, ( uint64_t ) wanted ) : 0;
+        if ( skipped == wanted ) {
+            return false; // the copy was completely overwritten
+        }
+        amount = wanted;
+    }
+    if ( amount == 0 ) {
+        return false;
+    }
+
+    // the samples are stored as differences between consecutive samples (which are small
+    // for most audio), separating the low and high bytes improves their compressibility
+
+    const int savedAmount = amount - skipped;
+    std::vector<uint8_t> raw(( size_t ) savedAmount * 2 * _amountOfChannels );
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+        const int16_t* samples = copy.data() + ( size_t ) c * amount + skipped;
+        uint8_t* low  = raw.data() + ( size_t ) c * savedAmount * 2;
+        uint8_t* high = low + savedAmount;
+        int previous  = 0;
+
+        for ( int i = 0; i < savedAmount; ++i ) {
+            int delta = ( int16_t ) ( samples[ i ] - previous );
+            previous  = samples[ i ];
+
+            uint16_t encoded = ( uint16_t ) ((( uint32_t ) delta << 1 ) ^ ( uint32_t ) ( delta >> 15 )); // zigzag
+            low[ i ]  = ( uint8_t ) encoded;
+            high[ i ] = ( uint8_t ) ( encoded >> 8 );
+        }
+    }
+    data.clear();
+    writeUint32( data, FORMAT_VERSION );
+    writeFloat( data, _sampleRate );
+    uint32_t readBits = ( uint32_t ) readWritePosition;
+    float readPosition;
+    memcpy( &readPosition, &readBits, sizeof( float ));
+
+    writeFloat( data, readLag );
+    writeFloat( data, readPosition );
+    writeUint32( data, ( uint32_t ) ( readWritePosition >> 32 ));
+    writeUint32( data, ( uint32_t ) _amountOfChannels );
+    writeUint32( data, ( uint32_t ) savedAmount );
+
+    compress( raw, data );
+
+    return true;
+}
+
+bool RecordingStore::load( const uint8_t* data, uint32_t size )
+{
+    collectFinishedRecording();
+
+    if ( size < HEADER_SIZE || readUint32( data ) != FORMAT_VERSION ) {
+        return false;
+    }
+    Recording* recording = new Recording();
+
+    recording->sampleRate       = readFloat( data + 4 );
+    recording->readLag          = std::max( 0.f, readFloat( data + 8 ));
+    recording->readPosition     = readFloat( data + 12 );
+    recording->writeIndex       = ( int ) readUint32( data + 16 );
+    recording->amountOfChannels = ( int ) readUint32( data + 20 );
+    recording->length           = ( int ) readUint32( data + 24 );
+
+    uint64_t rawSize = ( uint64_t ) recording->amountOfChannels * ( uint64_t ) recording->length * 2;
+    std::vector<uint8_t> raw;
+
+    if ( recording->amountOfChannels <= 0 || recording->length <= 0 || rawSize > MAX_RAW_SIZE ) {
+        delete recording;
+        return false;
+    }
+    raw.resize(( size_t ) rawSize );
+
+    if ( !decompress( data + HEADER_SIZE, size - HEADER_SIZE, raw )) {
+        delete recording;
+        return false;
+    }
+    recording->samples.resize(( size_t ) recording->amountOfChannels * recording->length );
+
+    for ( int c = 0; c < recording->amountOfChannels; ++c ) {
+        const uint8_t* low  = raw.data() + ( size_t ) c * recording->length * 2;
+        const uint8_t* high = low + recording->length;
+        float* samples = recording->getChannel( c );
+        int16_t previous = 0;
+
+        for ( int i = 0; i < recording->length; ++i ) {
+            uint16_t encoded = ( uint16_t ) ( low[ i ] | ( high[ i ] << 8 ));
+            int delta = ( int ) ( encoded >> 1 ) ^ -( int ) ( encoded & 1 );
+
+            previous     = ( int16_t ) ( previous + delta );
+            samples[ i ] = ( float ) previous / 32767.f;
+        }
+    }
+
+    // replaces a recording that wasn't restored yet
+
+    delete _pendingRecording.exchange( recording, std::memory_order_acq_rel );
+
+    return true;
+}
+
+RecordingStore::Recording* RecordingStore::beginRestore()
+{
+    // hand back a previously retired recording first (only one can be retired at a time)
+
+    if ( _retiredRecording != nullptr ) {
+        Recording* expected = nullptr;
+        if ( !_finishedRecording.compare_exchange_strong( expected, _retiredRecording, std::memory_order_acq_rel )) {
+            return nullptr;
+        }
+        _retiredRecording = nullptr;
+    }
+
+    if ( _pendingRecording.load( std::memory_order_relaxed ) == nullptr ) {
+        return nullptr;
+    }
+    _restoringRecording = _pendingRecording.exchange( nullptr, std::memory_order_acq_rel );
+
+    // the restored recording precedes the current write position, older recordings are discarded
+
+    _restorePosition = _position;
+    _restoredFrom    = _position;
+    _validFrom.store( _position, std::memory_order_release );
+
+    return _restoringRecording;
+}
+
+void RecordingStore::writeRestored( const Recording& recording, int offset, int length )
+{
+    if ( _size == 0 || recording.amountOfChannels != _amountOfChannels ) {
+        return;
+    }
+    // announce writing into the past of the ring (the fence orders the announcement before the samples)
+
+    _restores.store( _restores.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    for ( int i = offset; i < offset + length; ++i ) {
+        int distance = recording.length - i; // from the restore position
+        if ( distance > _size - _headroom ) {
+            continue;
+        }
+        uint64_t position = _restorePosition - ( uint64_t ) distance;
+
+        // samples that no longer fit behind the samples written since the restore started are discarded
+
+        if ( _position - position > ( uint64_t ) ( _size - _headroom )) {
+            continue;
+        }
+        int writeIndex = ( int ) ( position % ( uint64_t ) _size );
+
+        for ( int c = 0; c < _amountOfChannels; ++c ) {
+            float sample = std::max( -1.f, std::min( 1.f, recording.samples[( size_t ) c * recording.length + i ]));
+            _samples[( size_t ) c * _size + writeIndex ].store(( int16_t ) lrint( sample * 32767.f ), std::memory_order_relaxed );
+        }
+        _restoredFrom = std::min( _restoredFrom, position );
+    }
+}
+
+void RecordingStore::endRestore()
+{
+    // the restored samples become part of the recording once they are all written (as they are
+    // not restored in order, the range written so far can contain gaps until then)
+
+    if ( _restoringRecording != nullptr ) {
+        _validFrom.store( std::min( _validFrom.load( std::memory_order_relaxed ), _restoredFrom ), std::memory_order_release );
+    }
+    Recording* expected = nullptr;
+    if ( !_finishedRecording.compare_exchange_strong( expected, _restoringRecording, std::memory_order_acq_rel )) {
+        _retiredRecording = _restoringRecording;
+    }
+    _restoringRecording = nullptr;
+}
+
+/* private methods */
+
+void RecordingStore::collectFinishedRecording()
+{
+    delete _finishedRecording.exchange( nullptr, std::memory_order_acq_rel );
+}
+
+void RecordingStore::compress( const std::vector<uint8_t>& input, std::vector<uint8_t>& output )
+{
+    // each sequence consists of a token (the amount of literals in the upper and the match length in the
+    // lower four bits, which continue in successive bytes when 15), the literals and the offset of the
+    // match. The last sequence solely consists of literals (the decoder knows the decompressed size)
+
+    const uint8_t* data = input.data();
+    const int size = ( int ) input.size();
+
+    std::vector<int> table( 1 << HASH_BITS, -1 );
+
+    auto writeLength = [ &output ]( int length ) {
+        for ( ; length >= 255; length -= 255 ) {
+            output.push_back( 255 );
+        }
+        output.push_back(( uint8_t ) length );
+    };
+
+    auto writeSequence = [ & ]( int anchor, int literals, int offset, int matchLength ) {
+        int matchToken = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+        output.push_back(( uint8_t ) (( std::min( literals, 15 ) << 4 ) | std::min( matchToken, 15 )));
+
+        if ( literals >= 15 ) {
+            writeLength( literals - 15 );
+        }
+        output.insert( output.end(), data + anchor, data + anchor + literals );
+
+        if ( matchLength >= MIN_MATCH ) {
+            output.push_back(( uint8_t ) offset );
+            output.push_back(( uint8_t ) ( offset >> 8 ));
+
+            if ( matchToken >= 15 ) {
+                writeLength( matchToken - 15 );
+            }
+        }
+    };
+
+    int anchor = 0;
+    int i = 0;
+
+    while ( i + MIN_MATCH <= size ) {
+        uint32_t sequence;
+        memcpy( &sequence, data + i, sizeof( uint32_t ));
+
+        uint32_t hash = ( sequence * 2654435761u ) >> ( 32 - HASH_BITS );
+        int candidate = table[ hash ];
+        table[ hash ] = i;
+
+        if ( candidate >= 0 && i - candidate <= MAX_OFFSET && memcmp( data + candidate, data + i, MIN_MATCH ) == 0 ) {
+            int length = MIN_MATCH;
+            while ( i + length < size && data[ candidate + length ] == data[ i + length ]) {
+                ++length;
+            }
+            writeSequence( anchor, i - anchor, i - candidate, length );
+            i += length;
+            anchor = i;
+        } else {
+            ++i;
+        }
+    }
+    writeSequence( anchor, size - anchor, 0, 0 );
+}
+
+bool RecordingStore::decompress( const uint8_t* input, uint32_t size, std::vector<uint8_t>& output )
+{
+    uint32_t readIndex  = 0;
+    size_t   writeIndex = 0;
+
+    auto readLength = [ & ]( size_t& length ) {
+        uint8_t value;
+        do {
+            if ( readIndex >= size ) {
+                return false;
+            }
+            value = input[ readIndex++ ];
+            length += value;
+        } while ( value == 255 );
+        return true;
+    };
+
+    while ( readIndex < size ) {
+        uint8_t token = input[ readIndex++ ];
+
+        size_t literals = token >> 4;
+        if ( literals == 15 && !readLength( literals )) {
+            return false;
+        }
+        if ( literals > size - readIndex || literals > output.size() - writeIndex ) {
+            return false;
+        }
+        memcpy( output.data() + writeIndex, input + readIndex, literals );
+        readIndex  += ( uint32_t ) literals;
+        writeIndex += literals;
+
+        if ( writeIndex == output.size()) {
+            return true; // the last sequence has no match
+        }
+        if ( size - readIndex < 2 ) {
+            return false;
+        }
+        size_t offset = input[ readIndex ] | ( input[ readIndex + 1 ] << 8 );
+        readIndex += 2;
+
+        size_t length = token & 15;
+        if ( length == 15 && !readLength( length )) {
+            return false;
+        }
+        length += MIN_MATCH;
+
+        if ( offset == 0 || offset > writeIndex || length > output.size() - writeIndex ) {
+            return false;
+        }
+        // copied per byte as the match can overlap the output it is copied into
+
+        for ( size_t i = 0; i < length; ++i, ++writeIndex ) {
+            output[ writeIndex ] = output[ writeIndex - offset ];
+        }
+    }
+    return writeIndex == output.size();
+}
+
+}
@@ -0,0 +1,147 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RECORDINGSTORE_H_INCLUDED__
+#define __RECORDINGSTORE_H_INCLUDED__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Igorski {
+/**
+ * The RecordingStore allows the recorded audio to be saved in (and restored from) the plugin state, so slowed
+ * down playback doesn't have to build up its history again when a project is reloaded.
+ *
+ * While enabled, the process thread keeps a 16-bit copy of its input (see write()) which the thread saving the
+ * state reads from (it never accesses the record buffers of the process thread, which can be reallocated while
+ * processing). As the process thread keeps writing while the state is saved, the saving thread discards the samples
+ * that were overwritten while it was copying them (see save()). The recording is stored as compressed sample deltas.
+ * When loading, the recording is decoded outside of the process thread, after which the process thread restores it
+ * in blocks of bounded size (see beginRestore()).
+ */
+class RecordingStore
+{
+    public:
+        static constexpr float HISTORY_SECONDS  = 1.f;   // saved in addition to the distance between read and write pointer
+        static constexpr float HEADROOM_SECONDS = 1.f;   // recording that is never saved, so saving doesn't overlap writing
+        static constexpr int RESTORE_BLOCK_SIZE = 16384; // the maximum amount of samples restored per process cycle
+        static constexpr int SAVE_ATTEMPTS      = 3;     // the amount of copies made when a restore overwrites the recording while saving
+
+        // a decoded recording (the most recent samples of each channel)
+
+        struct Recording {
+            float sampleRate;
+            float readLag; // the distance between the read and write pointer at the moment of saving
+            float readPosition; // the read and write pointer (as record buffer indices) at the moment of saving
+            int writeIndex;
+            int amountOfChannels;
+            int length;
+            std::vector<float> samples; // all samples of the first channel, followed by those of the next channel, etc.
+
+            inline float* getChannel( int channel ) {
+                return samples.data() + channel * length;
+            }
+        };
+
+        RecordingStore();
+        ~RecordingStore();
+
+        // (re)allocates the store for given amount of seconds of audio (not to be invoked while processing)
+
+        void prepare( int amountOfChannels, float seconds, float sampleRate );
+
+        void setEnabled( bool enabled );
+        bool isEnabled();
+
+        // process thread: stores the input of the current process cycle and the read and write pointer at the end of
+        // the process cycle (the distance between these determines how much of the recording is required for playback)
+
+        template <typename SampleType>
+        void write( SampleType** channels, int numChannels, int bufferSize );
+        void setReadPosition( float readPosition, int writeIndex, float readLag );
+
+        // saving thread: encodes the recording required for playback into data
+        // returns false when nothing was recorded (or the store is disabled)
+
+        bool save( std::vector<uint8_t>& data );
+
+        // loading thread: decodes given data and queues the recording for restoration by the process thread
+        // returns false when the data isn't a valid recording
+
+        bool load( const uint8_t* data, uint32_t size );
+
+        // process thread: retrieves the queued recording to restore (returns nullptr when there is none), the recording
+        // remains valid until endRestore() is invoked. Restored samples are passed to writeRestored() (in any order) so they
+        // are saved along with the recording that is made after the restore, from the moment endRestore() is invoked
+
+        Recording* beginRestore();
+        void writeRestored( const Recording& recording, int offset, int length );
+        void endRestore();
+
+    private:
+        // per channel ring of _size samples, as the saving thread reads these while the process
+        // thread is writing, the samples are atomic (accessed using relaxed ordering, e.g. plain loads and stores)
+
+        std::unique_ptr<std::atomic<int16_t>[]> _samples;
+        int _size = 0;
+        int _amountOfChannels = 0;
+        int _history = 0;
+        int _headroom = 0;
+        float _sampleRate = 0.f;
+
+        // the process thread owns the ring and addresses it by absolute position (the amount of samples written
+        // since prepare(), the index in the ring being the position modulo _size). It publishes the range of
+        // valid samples and, before writing a block, the position up to which it is about to overwrite the ring.
+        // Restoring a recording writes into the past of the ring, which is announced by incrementing _restores
+
+        uint64_t _position        = 0;
+        uint64_t _restorePosition = 0; // write position at the start of the restore
+        uint64_t _restoredFrom    = 0; // oldest position written by the restore
+
+        std::atomic<uint64_t> _written{ 0 };   // the samples preceding this position are complete
+        std::atomic<uint64_t> _validFrom{ 0 }; // the samples from this position on are part of the (continuous) recording
+        std::atomic<uint64_t> _writing{ 0 };   // the samples preceding this position are (being) written
+        std::atomic<uint32_t> _restores{ 0 };
+        std::atomic<float> _readLag{ 0.f };
+        std::atomic<uint64_t> _readWritePosition{ 0 }; // the write index in the upper, the read position in the lower 32 bits
+        std::atomic<bool> _enabled{ false };
+
+        // recordings are passed from the loading thread to the process thread and back again (for deletion, as
+        // the process thread should not deallocate). A finished recording is retired when the previous one wasn't collected yet
+
+        std::atomic<Recording*> _pendingRecording{ nullptr };
+        std::atomic<Recording*> _finishedRecording{ nullptr };
+        Recording* _restoringRecording = nullptr;
+        Recording* _retiredRecording   = nullptr;
+
+        void collectFinishedRecording();
+
+        static void compress( const std::vector<uint8_t>& input, std::vector<uint8_t>& output );
+        static bool decompress( const uint8_t* input, uint32_t size, std::vector<uint8_t>& output );
+};
+}
+
+#include "recordingstore.tcc"
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+
+namespace Igorski {
+
+template <typename SampleType>
+void RecordingStore::write( SampleType** channels, int numChannels, int bufferSize )
+{
+    if ( !_enabled.load( std::memory_order_relaxed ) || _size == 0 ) {
+        if ( _validFrom.load( std::memory_order_relaxed ) != _position ) {
+            _validFrom.store( _position, std::memory_order_release ); // the recording is no longer continuous
+        }
+        return;
+    }
+    numChannels = std::min( numChannels, _amountOfChannels );
+
+    // announce the overwritten range before writing (the fence orders the announcement before the samples)
+
+    _writing.store( _position + bufferSize, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    const int startIndex = ( int ) ( _position % ( uint64_t ) _size );
+
+    for ( int c = 0; c < numChannels; ++c ) {
+        const SampleType* channel = channels[ c ];
+        std::atomic<int16_t>* samples = _samples.get() + ( size_t ) c * _size;
+        int writeIndex = startIndex;
+
+        for ( int i = 0; i < bufferSize; ++i, ++writeIndex ) {
+            if ( writeIndex == _size ) {
+                writeIndex = 0;
+            }
+            SampleType sample = std::max(( SampleType ) -1, std::min(( SampleType ) 1, channel[ i ]));
+            samples[ writeIndex ].store(( int16_t ) lrint( sample * ( SampleType ) 32767 ), std::memory_order_relaxed );
+        }
+    }
+    _position += bufferSize;
+    _written.store( _position, std::memory_order_release );
+}
+
+}
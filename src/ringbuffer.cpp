@@ -0,0 +1,96 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "ringbuffer.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+RingBuffer::RingBuffer( int capacity )
+{
+    int size = 1;
+    while ( size < capacity ) {
+        size <<= 1;
+    }
+    _buffer.resize( size, 0.f );
+    _mask = size - 1;
+}
+
+RingBuffer::~RingBuffer()
+{
+
+}
+
+/* public methods */
+
+int RingBuffer::write( const float* samples, int amount )
+{
+    unsigned int writeIndex = _writeIndex.load( std::memory_order_relaxed );
+    unsigned int readIndex  = _readIndex.load( std::memory_order_acquire );
+
+    amount = std::min( amount, ( int ) _buffer.size() - ( int ) ( writeIndex - readIndex ));
+
+    for ( int i = 0; i < amount; ++i ) {
+        _buffer[ ( writeIndex + i ) & _mask ] = samples[ i ];
+    }
+    _writeIndex.store( writeIndex + amount, std::memory_order_release );
+
+    return amount;
+}
+
+int RingBuffer::getFreeSpace()
+{
+    return ( int ) _buffer.size() - ( int ) ( _writeIndex.load( std::memory_order_relaxed ) - _readIndex.load( std::memory_order_acquire ));
+}
+
+int RingBuffer::read( float* samples, int amount )
+{
+    unsigned int readIndex = _readIndex.load( std::memory_order_relaxed );
+
+    amount = std::min( amount, ( int ) ( _writeIndex.load( std::memory_order_acquire ) - readIndex ));
+
+    for ( int i = 0; i < amount; ++i ) {
+        samples[ i ] = _buffer[ ( readIndex + i ) & _mask ];
+    }
+    _readIndex.store( readIndex + amount, std::memory_order_release );
+
+    return amount;
+}
+
+int RingBuffer::skip( int amount )
+{
+    unsigned int readIndex = _readIndex.load( std::memory_order_relaxed );
+
+    amount = std::min( amount, ( int ) ( _writeIndex.load( std::memory_order_acquire ) - readIndex ));
+    _readIndex.store( readIndex + amount, std::memory_order_release );
+
+    return amount;
+}
+
+int RingBuffer::getAvailable()
+{
+    return ( int ) ( _writeIndex.load( std::memory_order_acquire ) - _readIndex.load( std::memory_order_relaxed ));
+}
+
+}
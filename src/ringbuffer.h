@@ -0,0 +1,64 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RINGBUFFER_H_INCLUDED__
+#define __RINGBUFFER_H_INCLUDED__
+
+#include <atomic>
+#include <vector>
+
+namespace Igorski {
+/**
+ * A lock-free ring buffer of samples for a single producer and a single consumer thread
+ * (e.g. to pass audio from the process thread to the UI thread). Writing never waits: when
+ * the consumer isn't keeping up, the samples that don't fit are dropped.
+ */
+class RingBuffer
+{
+    public:
+        RingBuffer( int capacity ); // is rounded up to the next power of two
+        ~RingBuffer();
+
+        // producer: writes up to given amount of samples, returns the amount actually written
+
+        int write( const float* samples, int amount );
+        int getFreeSpace();
+
+        // consumer: reads up to given amount of samples, returns the amount actually read
+
+        int read( float* samples, int amount );
+        int skip( int amount );
+        int getAvailable();
+
+    private:
+        std::vector<float> _buffer;
+        int _mask;
+
+        // both indices increment indefinitely (wrapping is handled by the mask) and are
+        // only written by their owning thread, the cache line padding prevents false sharing
+
+        alignas( 64 ) std::atomic<unsigned int> _writeIndex{ 0 }; // owned by the producer
+        alignas( 64 ) std::atomic<unsigned int> _readIndex{ 0 };  // owned by the consumer
+};
+}
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "spectrumanalyzer.h"
+#include "global.h"
+#include <cmath>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+    _window.resize( FFT_SIZE );
+    _bitReversed.resize( FFT_SIZE );
+    _real.resize( FFT_SIZE, 0.f );
+    _imaginary.resize( FFT_SIZE, 0.f );
+    _cos.resize( FFT_SIZE / 2 );
+    _sin.resize( FFT_SIZE / 2 );
+
+    int bits = 0;
+    while (( 1 << bits ) < FFT_SIZE ) {
+        ++bits;
+    }
+
+    for ( int i = 0; i < FFT_SIZE; ++i ) {
+        // Hann window
+
+        _window[ i ] = .5f - .5f * cos( VST::TWO_PI * ( float ) i / ( float ) FFT_SIZE );
+
+        int reversed = 0;
+        for ( int bit = 0; bit < bits; ++bit ) {
+            reversed |= (( i >> bit ) & 1 ) << ( bits - 1 - bit );
+        }
+        _bitReversed[ i ] = reversed;
+    }
+
+    for ( int i = 0; i < FFT_SIZE / 2; ++i ) {
+        double angle = 2.0 * 3.141592653589793 * ( double ) i / ( double ) FFT_SIZE;
+        _cos[ i ] = ( float ) cos( angle );
+        _sin[ i ] = ( float ) sin( angle );
+    }
+    // the bands are calculated once the sample rate is known (see analyze())
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+
+}
+
+/* public methods */
+
+void SpectrumAnalyzer::analyze( float sampleRate )
+{
+    if ( sampleRate != _sampleRate ) {
+        calculateBands( sampleRate );
+    }
+    analyzeSignal( _input,  _spectrum.input );
+    analyzeSignal( _output, _spectrum.output );
+}
+
+const SpectrumAnalyzer::Spectrum& SpectrumAnalyzer::getSpectrum()
+{
+    return _spectrum;
+}
+
+/* private methods */
+
+void SpectrumAnalyzer::calculateBands( float sampleRate )
+{
+    _sampleRate = sampleRate;
+
+    float binWidth     = sampleRate / ( float ) FFT_SIZE;
+    float maxFrequency = std::min( MAX_FREQUENCY, sampleRate / 2.f );
+
+    for ( int band = 0; band <= BANDS; ++band ) {
+        float frequency = MIN_FREQUENCY * pow( maxFrequency / MIN_FREQUENCY, ( float ) band / ( float ) BANDS );
+        _bandStart[ band ] = std::min( FFT_SIZE / 2, ( int ) ( frequency / binWidth ));
+    }
+}
+
+void SpectrumAnalyzer::analyzeSignal( Signal& signal, float* bands )
+{
+    // append the newly written samples to the history (when more than FFT_SIZE
+    // samples were written since the last analysis, only the latest are used)
+
+    int available = signal.ring.getAvailable();
+    if ( available > FFT_SIZE ) {
+        signal.ring.skip( available - FFT_SIZE );
+        available = FFT_SIZE;
+    }
+    std::copy( signal.history.begin() + available, signal.history.end(), signal.history.begin());
+    signal.ring.read( signal.history.data() + FFT_SIZE - available, available );
+
+    for ( int i = 0; i < FFT_SIZE; ++i ) {
+        _real[ _bitReversed[ i ]]      = signal.history[ i ] * _window[ i ];
+        _imaginary[ _bitReversed[ i ]] = 0.f;
+    }
+    transform();
+
+    // the level of each band is its loudest bin, scaled for the one-sided spectrum and window gain
+
+    const float scale = 4.f / ( float ) FFT_SIZE;
+
+    for ( int band = 0; band < BANDS; ++band ) {
+        int start = _bandStart[ band ];
+        int end   = std::max( start + 1, _bandStart[ band + 1 ]);
+        float power = 0.f;
+
+        for ( int bin = start; bin < end && bin <= FFT_SIZE / 2; ++bin ) {
+            power = std::max( power, _real[ bin ] * _real[ bin ] + _imaginary[ bin ] * _imaginary[ bin ]);
+        }
+        float decibels = 20.f * log10( std::max( sqrt( power ) * scale, 1e-9f ));
+        float level    = std::max( 0.f, std::min( 1.f, 1.f - decibels / FLOOR_DB ));
+
+        // rise immediately, fall back gradually
+
+        bands[ band ] = level >= bands[ band ] ? level : bands[ band ] + ( level - bands[ band ]) * RELEASE;
+    }
+}
+
+void SpectrumAnalyzer::transform()
+{
+    // iterative radix-2 FFT, the input has been written in bit reversed order
+
+    for ( int size = 2; size <= FFT_SIZE; size <<= 1 ) {
+        int half = size >> 1;
+        int step = FFT_SIZE / size;
+
+        for ( int start = 0; start < FFT_SIZE; start += size ) {
+            for ( int k = 0; k < half; ++k ) {
+                float twiddleReal      = _cos[ k * step ];
+                float twiddleImaginary = -_sin[ k * step ];
+
+                int a = start + k;
+                int b = a + half;
+
+                float real      = twiddleReal * _real[ b ] - twiddleImaginary * _imaginary[ b ];
+                float imaginary = twiddleReal * _imaginary[ b ] + twiddleImaginary * _real[ b ];
+
+                _real[ b ]      = _real[ a ] - real;
+                _imaginary[ b ] = _imaginary[ a ] - imaginary;
+                _real[ a ]      += real;
+                _imaginary[ a ] += imaginary;
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SPECTRUMANALYZER_H_INCLUDED__
+#define __SPECTRUMANALYZER_H_INCLUDED__
+
+#include "ringbuffer.h"
+#include <vector>
+
+namespace Igorski {
+/**
+ * The SpectrumAnalyzer provides the spectra of the input and output signal, for display in the editor.
+ *
+ * The process thread merely writes the (mixed down) signals into a ring buffer (see writeInput() and writeOutput()),
+ * all analysis (windowing, FFT and smoothing) takes place on the thread invoking analyze(). All tables are
+ * calculated upfront so neither thread allocates after construction.
+ */
+class SpectrumAnalyzer
+{
+    public:
+        static constexpr int FFT_SIZE  = 2048;
+        static constexpr int BANDS     = 96;    // logarithmically spaced between MIN_FREQUENCY and MAX_FREQUENCY
+        static constexpr int RING_SIZE = 16384; // holds well over the amount of samples between two analyses
+
+        static constexpr float MIN_FREQUENCY = 20.f;
+        static constexpr float MAX_FREQUENCY = 20000.f;
+        static constexpr float FLOOR_DB      = -90.f; // level corresponding to a band value of 0
+        static constexpr float RELEASE       = .25f;  // the rate at which the bands fall back per analysis
+
+        // messages exchanged with the controller, the controller requests the spectrum
+        // which is sent in response (as the process thread should not send messages)
+
+        static constexpr const char* REQUEST_MESSAGE  = "SpectrumRequest";
+        static constexpr const char* SPECTRUM_MESSAGE = "Spectrum";
+        static constexpr const char* SPECTRUM_DATA    = "Spectrum"; // binary attribute holding the Spectrum
+
+        // the level of each band in the 0 - 1 range (from FLOOR_DB to 0 dBFS)
+
+        struct Spectrum {
+            float input[ BANDS ];
+            float output[ BANDS ];
+        };
+
+        SpectrumAnalyzer();
+        ~SpectrumAnalyzer();
+
+        // process thread: writes the mix down of given channels into the ring of the input/output signal
+
+        template <typename SampleType>
+        void writeInput( SampleType** channels, int numChannels, int amount );
+
+        template <typename SampleType>
+        void writeOutput( SampleType** channels, int numChannels, int amount );
+
+        // analysis thread: updates the spectra using the most recently written samples
+
+        void analyze( float sampleRate );
+        const Spectrum& getSpectrum();
+
+    private:
+        static constexpr int MIX_SIZE = 256; // amount of samples mixed down (on the stack) per ring write
+
+        struct Signal {
+            RingBuffer ring;
+            std::vector<float> history; // the most recent FFT_SIZE samples
+
+            Signal() : ring( RING_SIZE ), history( FFT_SIZE, 0.f ) {}
+        };
+
+        Signal _input;
+        Signal _output;
+        Spectrum _spectrum = {};
+
+        // the FFT is planned upfront, the bit reversal and twiddle factors are calculated on construction
+
+        std::vector<float> _window;
+        std::vector<int>   _bitReversed;
+        std::vector<float> _cos;
+        std::vector<float> _sin;
+        std::vector<float> _real;
+        std::vector<float> _imaginary;
+
+        // the first FFT bin of each band (and the end of the last band)
+
+        int _bandStart[ BANDS + 1 ];
+        float _sampleRate = 0.f;
+
+        template <typename SampleType>
+        void write( RingBuffer& ring, SampleType** channels, int numChannels, int amount );
+
+        void calculateBands( float sampleRate );
+        void analyzeSignal( Signal& signal, float* bands );
+        void transform();
+};
+}
+
+#include "spectrumanalyzer.tcc"
+
+#endif
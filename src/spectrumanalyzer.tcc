@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+template <typename SampleType>
+void SpectrumAnalyzer::writeInput( SampleType** channels, int numChannels, int amount )
+{
+    write<SampleType>( _input.ring, channels, numChannels, amount );
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::writeOutput( SampleType** channels, int numChannels, int amount )
+{
+    write<SampleType>( _output.ring, channels, numChannels, amount );
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::write( RingBuffer& ring, SampleType** channels, int numChannels, int amount )
+{
+    // only mix down what fits, when nothing is being analyzed (e.g. the editor is closed) the ring
+    // fills up after which writing costs no more than the free space lookup
+
+    amount = std::min( amount, ring.getFreeSpace());
+
+    if ( amount <= 0 || numChannels <= 0 ) {
+        return;
+    }
+    float mix[ MIX_SIZE ];
+    float gain = 1.f / ( float ) numChannels;
+
+    for ( int offset = 0; offset < amount; offset += MIX_SIZE ) {
+        int length = std::min( MIX_SIZE, amount - offset );
+
+        for ( int i = 0; i < length; ++i ) {
+            mix[ i ] = ( float ) channels[ 0 ][ offset + i ];
+        }
+        for ( int c = 1; c < numChannels; ++c ) {
+            const SampleType* channel = channels[ c ] + offset;
+
+            for ( int i = 0; i < length; ++i ) {
+                mix[ i ] += ( float ) channel[ i ];
+            }
+        }
+        for ( int i = 0; i < length; ++i ) {
+            mix[ i ] *= gain;
+        }
+        ring.write( mix, length );
+    }
+}
+
+}
@@ -23,8 +23,11 @@
 #include "../global.h"
 #include "../plugin_process.h"
 #include "controller.h"
+#include "spectrumview.h"
 #include "uimessagecontroller.h"
+#include "waveformview.h"
 #include "../paramids.h"
+#include "../pluginstate.h"
 
 #include "pluginterfaces/base/ibstream.h"
 #include "pluginterfaces/base/ustring.h"
@@ -37,6 +40,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#if SMTG_OS_WINDOWS
+#include <windows.h>
+#endif
+
 namespace Steinberg {
 namespace Vst {
 
@@ -163,6 +170,84 @@ tresult PLUGIN_API PluginController::initialize( FUnknown* context )
         STR16( "Bypass" ), nullptr, 1, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsBypass, kBypassId
     );
 
+    // LFO tempo sync (when enabled, the LFO rates select a note division of the host tempo)
+    parameters.addParameter(
+        STR16( "LFO tempo sync" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kLfoSyncId, unitId
+    );
+
+    // stores the recorded audio in the state, so slowed down playback resumes instantly when reloading a project
+    parameters.addParameter(
+        STR16( "Save recording" ), nullptr, 1, 0, ParameterInfo::kNoFlags, kSaveRecordingId, unitId
+    );
+
+    // the depth by which the envelope of the side chain input lowers each destination
+    // (only of effect in the side chain variant of the plugin, see vstentry.cpp)
+    RangeParameter* sideChainResampleParam = new RangeParameter(
+        USTRING( "Sidechain > resample rate" ), kSideChainResampleId, USTRING( "%" ),
+        0.f, 1.f, 0.f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainResampleParam );
+
+    RangeParameter* sideChainBitDepthParam = new RangeParameter(
+        USTRING( "Sidechain > resolution" ), kSideChainBitDepthId, USTRING( "%" ),
+        0.f, 1.f, 0.f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainBitDepthParam );
+
+    RangeParameter* sideChainPlaybackRateParam = new RangeParameter(
+        USTRING( "Sidechain > playback rate" ), kSideChainPlaybackRateId, USTRING( "%" ),
+        0.f, 1.f, 0.f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainPlaybackRateParam );
+
+    // down samples without aliasing (rather than using the characteristic aliasing filter)
+    // (changes the latency, hence not automatable)
+    parameters.addParameter(
+        STR16( "Clean down sampling" ), nullptr, 1, 0, ParameterInfo::kNoFlags, kCleanDownSamplingId, unitId
+    );
+
+    // interpolation used when reading the recording at a fractional position (e.g. when slowed down)
+    StringListParameter* interpolationParam = new StringListParameter(
+        STR16( "Interpolation" ), kInterpolationId, nullptr, ParameterInfo::kCanAutomate | ParameterInfo::kIsList, unitId
+    );
+    interpolationParam->appendString( STR16( "Hold" ));
+    interpolationParam->appendString( STR16( "Linear" ));
+    interpolationParam->appendString( STR16( "Hermite" ));
+    interpolationParam->appendString( STR16( "Sinc" ));
+    parameters.addParameter( interpolationParam );
+
+    // interpolates the oscillator wave tables (rather than stepping through the table entries)
+    parameters.addParameter(
+        STR16( "Smooth LFO" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kLfoInterpolationId, unitId
+    );
+
+    // runs the character filter in a topology that remains stable when the resample rate is modulated rapidly
+    parameters.addParameter(
+        STR16( "Stable filter" ), nullptr, 1, 0, ParameterInfo::kCanAutomate, kStableFilterId, unitId
+    );
+
+    // enables the lookahead of the output limiter (changes the latency, hence not automatable)
+    parameters.addParameter(
+        STR16( "Limiter lookahead" ), nullptr, 1, 0, ParameterInfo::kNoFlags, kLimiterLookaheadId, unitId
+    );
+
+    // oversampling of the nonlinear processes (changes the latency, hence not automatable)
+    StringListParameter* oversamplingParam = new StringListParameter(
+        STR16( "Oversampling" ), kOversamplingId, nullptr, ParameterInfo::kIsList, unitId
+    );
+    oversamplingParam->appendString( STR16( "Off" ));
+    oversamplingParam->appendString( STR16( "2x" ));
+    oversamplingParam->appendString( STR16( "4x" ));
+    parameters.addParameter( oversamplingParam );
+
+    // output meters (read only, written by the processor once per process cycle)
+    parameters.addParameter( STR16( "Output peak" ),    nullptr, 0, 0, ParameterInfo::kIsReadOnly, kVuPPMId,         unitId );
+    parameters.addParameter( STR16( "Output RMS" ),     nullptr, 0, 0, ParameterInfo::kIsReadOnly, kOutputRmsId,     unitId );
+    parameters.addParameter( STR16( "Gain reduction" ), nullptr, 0, 0, ParameterInfo::kIsReadOnly, kGainReductionId, unitId );
+
     // initialization
 
     String str( "Homecorrupter" );
@@ -181,99 +266,77 @@ tresult PLUGIN_API PluginController::terminate()
 tresult PLUGIN_API PluginController::setComponentState( IBStream* state )
 {
     // we receive the current state of the component (processor part)
-    if ( state )
-    {
-// --- AUTO-GENERATED SETSTATE START
+    // parameters that are not present in the state (e.g. when saved by an older version) retain their value
 
-        float savedResampleRate = 1.f;
-        if ( state->read( &savedResampleRate, sizeof( float )) != kResultOk )
-            return kResultFalse;
-
-        float savedBitDepth = 1.f;
-        if ( state->read( &savedBitDepth, sizeof( float )) != kResultOk )
-            return kResultFalse;
-
-        float savedPlaybackRate = 1.f;
-        if ( state->read( &savedPlaybackRate, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    if ( !state )
+        return kResultOk;
 
-        float savedResampleLfo = 1.f;
-        if ( state->read( &savedResampleLfo, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    Igorski::PluginState pluginState;
+    if ( !pluginState.read( state ))
+        return kResultFalse;
 
-        float savedResampleLfoDepth = 1.f;
-        if ( state->read( &savedResampleLfoDepth, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    float value;
 
-        float savedBitCrushLfo = 1.f;
-        if ( state->read( &savedBitCrushLfo, sizeof( float )) != kResultOk )
-            return kResultFalse;
+// --- AUTO-GENERATED SETSTATE START
+    if ( pluginState.getParameter( kResampleRateId, value ))
+        setParamNormalized( kResampleRateId, value );
+    if ( pluginState.getParameter( kBitDepthId, value ))
+        setParamNormalized( kBitDepthId, value );
+    if ( pluginState.getParameter( kPlaybackRateId, value ))
+        setParamNormalized( kPlaybackRateId, value );
+    if ( pluginState.getParameter( kResampleLfoId, value ))
+        setParamNormalized( kResampleLfoId, value );
+    if ( pluginState.getParameter( kResampleLfoDepthId, value ))
+        setParamNormalized( kResampleLfoDepthId, value );
+    if ( pluginState.getParameter( kBitCrushLfoId, value ))
+        setParamNormalized( kBitCrushLfoId, value );
+    if ( pluginState.getParameter( kBitCrushLfoDepthId, value ))
+        setParamNormalized( kBitCrushLfoDepthId, value );
+    if ( pluginState.getParameter( kPlaybackRateLfoId, value ))
+        setParamNormalized( kPlaybackRateLfoId, value );
+    if ( pluginState.getParameter( kPlaybackRateLfoDepthId, value ))
+        setParamNormalized( kPlaybackRateLfoDepthId, value );
+    if ( pluginState.getParameter( kWetMixId, value ))
+        setParamNormalized( kWetMixId, value );
+    if ( pluginState.getParameter( kDryMixId, value ))
+        setParamNormalized( kDryMixId, value );
 
-        float savedBitCrushLfoDepth = 1.f;
-        if ( state->read( &savedBitCrushLfoDepth, sizeof( float )) != kResultOk )
-            return kResultFalse;
+// --- AUTO-GENERATED SETSTATE END
 
-        float savedPlaybackRateLfo = 1.f;
-        if ( state->read( &savedPlaybackRateLfo, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    if ( pluginState.getParameter( kBypassId, value ))
+        setParamNormalized( kBypassId, value >= .5f ? 1 : 0 );
 
-        float savedPlaybackRateLfoDepth = 1.f;
-        if ( state->read( &savedPlaybackRateLfoDepth, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    if ( pluginState.getParameter( kLfoSyncId, value ))
+        setParamNormalized( kLfoSyncId, value >= .5f ? 1 : 0 );
 
-        float savedWetMix = 1.f;
-        if ( state->read( &savedWetMix, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    if ( pluginState.getParameter( kSaveRecordingId, value ))
+        setParamNormalized( kSaveRecordingId, value >= .5f ? 1 : 0 );
 
-        float savedDryMix = 1.f;
-        if ( state->read( &savedDryMix, sizeof( float )) != kResultOk )
-            return kResultFalse;
+    if ( pluginState.getParameter( kSideChainResampleId, value ))
+        setParamNormalized( kSideChainResampleId, value );
+    if ( pluginState.getParameter( kSideChainBitDepthId, value ))
+        setParamNormalized( kSideChainBitDepthId, value );
+    if ( pluginState.getParameter( kSideChainPlaybackRateId, value ))
+        setParamNormalized( kSideChainPlaybackRateId, value );
 
-// --- AUTO-GENERATED SETSTATE END
+    if ( pluginState.getParameter( kLimiterLookaheadId, value ))
+        setParamNormalized( kLimiterLookaheadId, value >= .5f ? 1 : 0 );
 
-        int32 savedBypass = 0;
-        if ( state->read( &savedBypass, sizeof( int32 )) != kResultOk )
-            return kResultFalse;
+    if ( pluginState.getParameter( kCleanDownSamplingId, value ))
+        setParamNormalized( kCleanDownSamplingId, value >= .5f ? 1 : 0 );
 
-#if BYTEORDER == kBigEndian
+    if ( pluginState.getParameter( kOversamplingId, value ))
+        setParamNormalized( kOversamplingId, value );
 
-// --- AUTO-GENERATED SETSTATE SWAP START
-    SWAP_32( savedResampleRate )
-    SWAP_32( savedBitDepth )
-    SWAP_32( savedPlaybackRate )
-    SWAP_32( savedResampleLfo )
-    SWAP_32( savedResampleLfoDepth )
-    SWAP_32( savedBitCrushLfo )
-    SWAP_32( savedBitCrushLfoDepth )
-    SWAP_32( savedPlaybackRateLfo )
-    SWAP_32( savedPlaybackRateLfoDepth )
-    SWAP_32( savedWetMix )
-    SWAP_32( savedDryMix )
+    if ( pluginState.getParameter( kInterpolationId, value ))
+        setParamNormalized( kInterpolationId, value );
 
-// --- AUTO-GENERATED SETSTATE SWAP END
+    if ( pluginState.getParameter( kLfoInterpolationId, value ))
+        setParamNormalized( kLfoInterpolationId, value >= .5f ? 1 : 0 );
 
-    SWAP_32( savedBypass );
+    if ( pluginState.getParameter( kStableFilterId, value ))
+        setParamNormalized( kStableFilterId, value >= .5f ? 1 : 0 );
 
-#endif
-// --- AUTO-GENERATED SETSTATE SETPARAM START
-        setParamNormalized( kResampleRateId, savedResampleRate );
-        setParamNormalized( kBitDepthId, savedBitDepth );
-        setParamNormalized( kPlaybackRateId, savedPlaybackRate );
-        setParamNormalized( kResampleLfoId, savedResampleLfo );
-        setParamNormalized( kResampleLfoDepthId, savedResampleLfoDepth );
-        setParamNormalized( kBitCrushLfoId, savedBitCrushLfo );
-        setParamNormalized( kBitCrushLfoDepthId, savedBitCrushLfoDepth );
-        setParamNormalized( kPlaybackRateLfoId, savedPlaybackRateLfo );
-        setParamNormalized( kPlaybackRateLfoDepthId, savedPlaybackRateLfoDepth );
-        setParamNormalized( kWetMixId, savedWetMix );
-        setParamNormalized( kDryMixId, savedDryMix );
-
-// --- AUTO-GENERATED SETSTATE SETPARAM END
-
-    setParamNormalized( kBypassId, savedBypass ? 1 : 0 );
-
-        state->seek( sizeof ( float ), IBStream::kIBSeekCur );
-    }
     return kResultOk;
 }
 
@@ -303,6 +366,58 @@ IController* PluginController::createSubController( UTF8StringPtr name,
     return nullptr;
 }
 
+//------------------------------------------------------------------------
+CView* PluginController::createCustomView( UTF8StringPtr name, const UIAttributes& /*attributes*/,
+                                           const IUIDescription* /*description*/, VST3Editor* /*editor*/ )
+{
+    if ( UTF8StringView( name ) == "WaveformView" )
+    {
+        waveformView = new WaveformView( CRect());
+        return waveformView;
+    }
+    if ( UTF8StringView( name ) == "SpectrumView" )
+    {
+        spectrumView = new SpectrumView( CRect());
+        return spectrumView;
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------
+void PluginController::didOpen( VST3Editor* editor )
+{
+    openEditor = editor;
+    requestProcessorUpdates();
+
+    // while the editor is hidden (e.g. obscured by the host or minimized), the changes keep being
+    // collected and the processor isn't queried, the editor is updated once it is visible again
+
+    updateTimer = makeOwned<CVSTGUITimer>( [ this ]( CVSTGUITimer* ) {
+        if ( !isEditorVisible())
+            return;
+
+        flushParameterChanges();
+        requestProcessorUpdates();
+    }, UPDATE_INTERVAL );
+}
+
+//------------------------------------------------------------------------
+void PluginController::willClose( VST3Editor* /*editor*/ )
+{
+    if ( updateTimer )
+    {
+        updateTimer->stop();
+        updateTimer = nullptr;
+    }
+    flushParameterChanges();
+
+    // the views are owned (and deleted) by the editor
+
+    openEditor   = nullptr;
+    waveformView = nullptr;
+    spectrumView = nullptr;
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::setState( IBStream* state )
 {
@@ -360,10 +475,33 @@ tresult PluginController::receiveText( const char* text )
 tresult PLUGIN_API PluginController::setParamNormalized( ParamID tag, ParamValue value )
 {
     // called from host to update our parameters state
+
+    if ( isLatencyParameter( tag ) && value != getParamNormalized( tag ))
+        restartForLatencyParameter( tag, value );
+
+    // while the editor is open, the change is applied on the next update (see flushParameterChanges())
+
+    if ( updateTimer && getParameterObject( tag ))
+    {
+        pendingParameterChanges[ tag ] = value;
+        return kResultOk;
+    }
     tresult result = EditControllerEx1::setParamNormalized( tag, value );
     return result;
 }
 
+//------------------------------------------------------------------------
+ParamValue PLUGIN_API PluginController::getParamNormalized( ParamID tag )
+{
+    // changes that have not been applied yet are the actual value of the parameter
+
+    auto pendingChange = pendingParameterChanges.find( tag );
+    if ( pendingChange != pendingParameterChanges.end())
+        return pendingChange->second;
+
+    return EditControllerEx1::getParamNormalized( tag );
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::getParamStringByValue( ParamID tag, ParamValue valueNormalized, String128 string )
 {
@@ -459,6 +597,180 @@ tresult PLUGIN_API PluginController::getParamValueByString( ParamID tag, TChar*
     return EditControllerEx1::getParamValueByString( tag, string, valueNormalized );
 }
 
+//------------------------------------------------------------------------
+tresult PLUGIN_API PluginController::notify( IMessage* message )
+{
+    if ( !message )
+        return kInvalidArgument;
+
+    // the processing time statistics sent by the processor in response to requestProcessorUpdates()
+
+    if ( !strcmp( message->getMessageID(), Igorski::DeadlineMonitor::STATISTICS_MESSAGE ))
+    {
+        const void* data;
+        uint32 size;
+        if ( message->getAttributes()->getBinary( Igorski::DeadlineMonitor::STATISTICS_DATA, data, size ) == kResultOk &&
+             size == sizeof( Igorski::DeadlineMonitor::Statistics ))
+        {
+            memcpy( &deadlineStatistics, data, size );
+        }
+        return kResultOk;
+    }
+
+#ifdef HC_PROFILE
+    if ( !strcmp( message->getMessageID(), Igorski::Profiler::REPORT_MESSAGE ))
+    {
+        const void* data;
+        uint32 size;
+        if ( message->getAttributes()->getBinary( Igorski::Profiler::REPORT_DATA, data, size ) == kResultOk &&
+             size == sizeof( Igorski::Profiler::Report ))
+        {
+            memcpy( &profilerReport, data, size );
+        }
+        return kResultOk;
+    }
+#endif
+
+    // the overview of the record buffer, likewise sent in response to requestProcessorUpdates()
+
+    if ( !strcmp( message->getMessageID(), Igorski::WaveformOverview::SNAPSHOT_MESSAGE ))
+    {
+        const void* data;
+        uint32 size;
+        if ( waveformView &&
+             message->getAttributes()->getBinary( Igorski::WaveformOverview::SNAPSHOT_DATA, data, size ) == kResultOk &&
+             size == sizeof( Igorski::WaveformOverview::Snapshot ))
+        {
+            waveformView->setSnapshot( *static_cast<const Igorski::WaveformOverview::Snapshot*>( data ));
+        }
+        return kResultOk;
+    }
+
+    if ( !strcmp( message->getMessageID(), Igorski::SpectrumAnalyzer::SPECTRUM_MESSAGE ))
+    {
+        const void* data;
+        uint32 size;
+        if ( spectrumView &&
+             message->getAttributes()->getBinary( Igorski::SpectrumAnalyzer::SPECTRUM_DATA, data, size ) == kResultOk &&
+             size == sizeof( Igorski::SpectrumAnalyzer::Spectrum ))
+        {
+            spectrumView->setSpectrum( *static_cast<const Igorski::SpectrumAnalyzer::Spectrum*>( data ));
+        }
+        return kResultOk;
+    }
+    return EditControllerEx1::notify( message );
+}
+
+//------------------------------------------------------------------------
+const Igorski::DeadlineMonitor::Statistics& PluginController::getDeadlineStatistics()
+{
+    return deadlineStatistics;
+}
+
+#ifdef HC_PROFILE
+//------------------------------------------------------------------------
+const Igorski::Profiler::Report& PluginController::getProfilerReport()
+{
+    return profilerReport;
+}
+#endif
+
+//------------------------------------------------------------------------
+void PluginController::flushParameterChanges()
+{
+    if ( pendingParameterChanges.empty())
+        return;
+
+    // updating the parameters notifies the controls, which invalidate their area so the editor
+    // redraws all changes at once. The changes are swapped out first as updates can lead to
+    // new changes (e.g. when the host responds to an edit)
+
+    std::map<ParamID, ParamValue> changes;
+    changes.swap( pendingParameterChanges );
+
+    for ( const auto& change : changes )
+        EditControllerEx1::setParamNormalized( change.first, change.second );
+}
+
+//------------------------------------------------------------------------
+bool PluginController::isEditorVisible()
+{
+    CFrame* frame = openEditor ? openEditor->getFrame() : nullptr;
+
+    if ( !frame || !frame->isVisible())
+        return false;
+
+#if SMTG_OS_WINDOWS
+    // the frame remains visible when the window hosting it is hidden or minimized
+
+    HWND window = ( HWND ) frame->getSystemWindow();
+
+    if ( window )
+    {
+        HWND rootWindow = GetAncestor( window, GA_ROOT );
+        return IsWindowVisible( window ) && !IsIconic( rootWindow ? rootWindow : window );
+    }
+#endif
+    return true;
+}
+
+//------------------------------------------------------------------------
+bool PluginController::isLatencyParameter( ParamID tag )
+{
+    switch ( tag )
+    {
+        case kLimiterLookaheadId:
+        case kOversamplingId:
+        case kCleanDownSamplingId:
+            return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------
+void PluginController::restartForLatencyParameter( ParamID tag, ParamValue value )
+{
+    // the processor receives parameter changes in its next process cycle, which can be after the host
+    // queried the new latency. As such the change is also sent directly, allowing the processor to
+    // apply it while the host restarts it (see Homecorrupter::setActive())
+
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( Igorski::VST::LATENCY_PARAMETER_MESSAGE );
+        message->getAttributes()->setInt( Igorski::VST::LATENCY_PARAMETER_ID, tag );
+        message->getAttributes()->setFloat( Igorski::VST::LATENCY_PARAMETER_VALUE, value );
+        sendMessage( message );
+    }
+
+    if ( componentHandler )
+        componentHandler->restartComponent( kLatencyChanged );
+}
+
+//------------------------------------------------------------------------
+void PluginController::requestProcessorUpdates()
+{
+    sendRequest( Igorski::DeadlineMonitor::REQUEST_MESSAGE );
+#ifdef HC_PROFILE
+    sendRequest( Igorski::Profiler::REQUEST_MESSAGE );
+#endif
+
+    if ( waveformView )
+        sendRequest( Igorski::WaveformOverview::REQUEST_MESSAGE );
+
+    if ( spectrumView )
+        sendRequest( Igorski::SpectrumAnalyzer::REQUEST_MESSAGE );
+}
+
+//------------------------------------------------------------------------
+void PluginController::sendRequest( const char* messageId )
+{
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( messageId );
+        sendMessage( message );
+    }
+}
+
 //------------------------------------------------------------------------
 void PluginController::addUIMessageController( UIMessageController* controller )
 {
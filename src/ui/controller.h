@@ -24,8 +24,14 @@
 #define __CONTROLLER_HEADER__
 
 #include "vstgui/plugin-bindings/vst3editor.h"
+#include "vstgui/lib/cvstguitimer.h"
 #include "public.sdk/source/vst/vsteditcontroller.h"
+#include "../deadlinemonitor.h"
+#include "../profiler.h"
+#include "../spectrumanalyzer.h"
+#include "../waveformoverview.h"
 
+#include <map>
 #include <vector>
 
 namespace Steinberg {
@@ -36,6 +42,9 @@ using namespace VSTGUI;
 template<typename T>
 class PluginUIMessageController;
 
+class SpectrumView;
+class WaveformView;
+
 class PluginController : public EditControllerEx1, public IMidiMapping, public VSTGUI::VST3EditorDelegate
 {
     public:
@@ -59,6 +68,7 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         tresult PLUGIN_API setState( IBStream* state ) SMTG_OVERRIDE;
         tresult PLUGIN_API getState( IBStream* state ) SMTG_OVERRIDE;
         tresult PLUGIN_API setParamNormalized( ParamID tag, ParamValue value) SMTG_OVERRIDE;
+        ParamValue PLUGIN_API getParamNormalized( ParamID tag ) SMTG_OVERRIDE;
         tresult PLUGIN_API getParamStringByValue( ParamID tag, ParamValue valueNormalized,
                                                   String128 string ) SMTG_OVERRIDE;
         tresult PLUGIN_API getParamValueByString( ParamID tag, TChar* string,
@@ -66,6 +76,7 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
 
         //---from ComponentBase-----
         tresult receiveText( const char* text ) SMTG_OVERRIDE;
+        tresult PLUGIN_API notify( IMessage* message ) SMTG_OVERRIDE;
 
         //---from IMidiMapping-----------------
         tresult PLUGIN_API getMidiControllerAssignment (int32 busIndex, int16 channel,
@@ -75,6 +86,10 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         //---from VST3EditorDelegate-----------
         IController* createSubController( UTF8StringPtr name, const IUIDescription* description,
                                           VST3Editor* editor ) SMTG_OVERRIDE;
+        CView* createCustomView( UTF8StringPtr name, const UIAttributes& attributes,
+                                 const IUIDescription* description, VST3Editor* editor ) SMTG_OVERRIDE;
+        void didOpen( VST3Editor* editor ) SMTG_OVERRIDE;
+        void willClose( VST3Editor* editor ) SMTG_OVERRIDE;
 
         DELEGATE_REFCOUNT ( EditController )
         tresult PLUGIN_API queryInterface( const char* iid, void** obj ) SMTG_OVERRIDE;
@@ -86,11 +101,54 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         void setDefaultMessageText( String128 text );
         TChar* getDefaultMessageText();
 
+        // the most recently received processing time statistics of the processor (see Igorski::DeadlineMonitor)
+
+        const Igorski::DeadlineMonitor::Statistics& getDeadlineStatistics();
+
+#ifdef HC_PROFILE
+        // the most recently received cycles spent in each stage of the process cycle (see Igorski::Profiler)
+
+        const Igorski::Profiler::Report& getProfilerReport();
+#endif
+
     private:
         typedef std::vector<UIMessageController*> UIMessageControllerList;
         UIMessageControllerList uiMessageControllers;
 
         String128 defaultMessageText;
+
+        // while the editor is open, the deadline statistics, record buffer overview and
+        // spectra are requested from the processor periodically. This is also the rate
+        // at which parameter changes are applied to the editor (see flushParameterChanges())
+
+        static const uint32 UPDATE_INTERVAL = 33; // in milliseconds, caps the editor at ~30 fps
+
+        SharedPointer<CVSTGUITimer> updateTimer;
+        Igorski::DeadlineMonitor::Statistics deadlineStatistics = {};
+#ifdef HC_PROFILE
+        Igorski::Profiler::Report profilerReport = {};
+#endif
+        WaveformView* waveformView = nullptr;
+        SpectrumView* spectrumView = nullptr;
+
+        // while the editor is open, parameter changes (e.g. automation and meters) are collected
+        // (keeping only the last value of each parameter) rather than updating the controls directly
+
+        std::map<ParamID, ParamValue> pendingParameterChanges;
+
+        void flushParameterChanges();
+
+        // whether the open editor is visible (its frame is shown and the window hosting it isn't minimized)
+
+        VST3Editor* openEditor = nullptr;
+        bool isEditorVisible();
+
+        // parameters affecting the latency of the processor require the host to restart the processor
+
+        static bool isLatencyParameter( ParamID tag );
+        void restartForLatencyParameter( ParamID tag, ParamValue value );
+        void requestProcessorUpdates();
+        void sendRequest( const char* messageId );
 };
 
 //------------------------------------------------------------------------
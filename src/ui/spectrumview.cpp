@@ -0,0 +1,80 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "spectrumview.h"
+#include "vstgui/lib/cdrawcontext.h"
+
+using namespace VSTGUI;
+
+namespace Steinberg {
+namespace Vst {
+
+//------------------------------------------------------------------------
+SpectrumView::SpectrumView( const CRect& size ) : CView( size )
+{
+    setMouseEnabled( false );
+}
+
+//------------------------------------------------------------------------
+void SpectrumView::setSpectrum( const Igorski::SpectrumAnalyzer::Spectrum& newSpectrum )
+{
+    spectrum = newSpectrum;
+    invalid();
+}
+
+//------------------------------------------------------------------------
+void SpectrumView::draw( CDrawContext* context )
+{
+    context->setFillColor( CColor( 0, 0, 0, 96 ));
+    context->drawRect( getViewSize(), kDrawFilled );
+
+    context->setLineWidth( 1 );
+    context->setDrawMode( kAntiAliasing );
+
+    // the output is drawn over the input, so added aliasing and crush artifacts stand out
+
+    drawBands( context, spectrum.input,  CColor( 255, 255, 255, 128 ));
+    drawBands( context, spectrum.output, CColor( 0, 200, 255, 255 ));
+
+    setDirty( false );
+}
+
+//------------------------------------------------------------------------
+void SpectrumView::drawBands( CDrawContext* context, const float* bands, const CColor& color )
+{
+    const CRect& bounds = getViewSize();
+    const CCoord bandWidth = bounds.getWidth() / ( Igorski::SpectrumAnalyzer::BANDS - 1 );
+
+    context->setFrameColor( color );
+
+    for ( int i = 1; i < Igorski::SpectrumAnalyzer::BANDS; ++i )
+    {
+        context->drawLine(
+            CPoint( bounds.left + ( i - 1 ) * bandWidth, bounds.bottom - bands[ i - 1 ] * bounds.getHeight()),
+            CPoint( bounds.left + i * bandWidth,         bounds.bottom - bands[ i ] * bounds.getHeight())
+        );
+    }
+}
+
+//------------------------------------------------------------------------
+} // namespace Vst
+} // namespace Steinberg
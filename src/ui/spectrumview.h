@@ -0,0 +1,58 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SPECTRUMVIEW_HEADER__
+#define __SPECTRUMVIEW_HEADER__
+
+#include "vstgui/lib/cview.h"
+#include "../spectrumanalyzer.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg {
+namespace Vst {
+
+//------------------------------------------------------------------------
+// SpectrumView
+// draws the spectra of the input and output signal, as received from the processor
+//------------------------------------------------------------------------
+class SpectrumView : public VSTGUI::CView
+{
+    public:
+        SpectrumView( const VSTGUI::CRect& size );
+
+        // copies given spectrum (see Igorski::SpectrumAnalyzer) and schedules a redraw
+
+        void setSpectrum( const Igorski::SpectrumAnalyzer::Spectrum& spectrum );
+
+        void draw( VSTGUI::CDrawContext* context ) SMTG_OVERRIDE;
+
+    private:
+        Igorski::SpectrumAnalyzer::Spectrum spectrum = {};
+
+        void drawBands( VSTGUI::CDrawContext* context, const float* bands, const VSTGUI::CColor& color );
+};
+
+//------------------------------------------------------------------------
+} // namespace Vst
+} // namespace Steinberg
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "waveformview.h"
+#include "vstgui/lib/cdrawcontext.h"
+
+using namespace VSTGUI;
+
+namespace Steinberg {
+namespace Vst {
+
+//------------------------------------------------------------------------
+WaveformView::WaveformView( const CRect& size ) : CView( size )
+{
+    setMouseEnabled( false );
+}
+
+//------------------------------------------------------------------------
+void WaveformView::setSnapshot( const Igorski::WaveformOverview::Snapshot& newSnapshot )
+{
+    snapshot = newSnapshot;
+    invalid();
+}
+
+//------------------------------------------------------------------------
+void WaveformView::draw( CDrawContext* context )
+{
+    const CRect& bounds = getViewSize();
+
+    context->setFillColor( CColor( 0, 0, 0, 96 ));
+    context->drawRect( bounds, kDrawFilled );
+
+    if ( snapshot.amountOfBins <= 0 )
+    {
+        setDirty( false );
+        return;
+    }
+
+    context->setLineWidth( 1 );
+    context->setDrawMode( kAliasing );
+
+    // each bin is drawn as a vertical line spanning its minimum and maximum value
+
+    const CCoord width  = bounds.getWidth();
+    const CCoord center = bounds.top + bounds.getHeight() / 2;
+    const CCoord scale  = bounds.getHeight() / 2;
+    const CCoord binWidth = width / snapshot.amountOfBins;
+
+    context->setFrameColor( CColor( 255, 255, 255, 160 ));
+
+    for ( int i = 0; i < snapshot.amountOfBins; ++i )
+    {
+        CCoord x = bounds.left + i * binWidth;
+        context->drawLine(
+            CPoint( x, center - snapshot.maximum[ i ] * scale ),
+            CPoint( x, center - snapshot.minimum[ i ] * scale + 1 )
+        );
+    }
+
+    // the read and write pointers
+
+    CCoord readX  = bounds.left + snapshot.readPosition  * width;
+    CCoord writeX = bounds.left + snapshot.writePosition * width;
+
+    context->setFrameColor( CColor( 0, 200, 255, 255 ));
+    context->drawLine( CPoint( readX, bounds.top ), CPoint( readX, bounds.bottom ));
+
+    context->setFrameColor( CColor( 255, 64, 64, 255 ));
+    context->drawLine( CPoint( writeX, bounds.top ), CPoint( writeX, bounds.bottom ));
+
+    setDirty( false );
+}
+
+//------------------------------------------------------------------------
+} // namespace Vst
+} // namespace Steinberg
@@ -0,0 +1,57 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WAVEFORMVIEW_HEADER__
+#define __WAVEFORMVIEW_HEADER__
+
+#include "vstgui/lib/cview.h"
+#include "../waveformoverview.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg {
+namespace Vst {
+
+//------------------------------------------------------------------------
+// WaveformView
+// draws the contents of the record buffer and the position of its
+// read and write pointers, as received from the processor
+//------------------------------------------------------------------------
+class WaveformView : public VSTGUI::CView
+{
+    public:
+        WaveformView( const VSTGUI::CRect& size );
+
+        // copies given snapshot (see Igorski::WaveformOverview) and schedules a redraw
+
+        void setSnapshot( const Igorski::WaveformOverview::Snapshot& snapshot );
+
+        void draw( VSTGUI::CDrawContext* context ) SMTG_OVERRIDE;
+
+    private:
+        Igorski::WaveformOverview::Snapshot snapshot = {};
+};
+
+//------------------------------------------------------------------------
+} // namespace Vst
+} // namespace Steinberg
+
+#endif
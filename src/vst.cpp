@@ -24,6 +24,7 @@
 #include "vst.h"
 #include "paramids.h"
 #include "calc.h"
+#include "pluginstate.h"
 
 #include "public.sdk/source/vst/vstaudioprocessoralgo.h"
 
@@ -42,10 +43,11 @@ float VST::SAMPLE_RATE = 44100.f; // updated in setupProcessing()
 //------------------------------------------------------------------------
 // Plugin Implementation
 //------------------------------------------------------------------------
-Homecorrupter::Homecorrupter()
+Homecorrupter::Homecorrupter( bool hasSideChain )
 : pluginProcess( nullptr )
 , outputGainOld( 0.f )
 , currentProcessMode( -1 ) // -1 means not initialized
+, _hasSideChain( hasSideChain )
 {
     // register its editor class (the same as used in vstentry.cpp)
     setControllerClass( VST::PluginControllerUID );
@@ -73,6 +75,7 @@ tresult PLUGIN_API Homecorrupter::initialize( FUnknown* context )
     //---create Audio In/Out buses------
     addAudioInput ( STR16( "Stereo In" ),  SpeakerArr::kStereo );
     addAudioOutput( STR16( "Stereo Out" ), SpeakerArr::kStereo );
+    addSideChainInput( SpeakerArr::kStereo );
 
     //---create Event In/Out buses (1 bus with only 1 channel)------
     addEventInput( STR16( "Event In" ), 1 );
@@ -95,8 +98,30 @@ tresult PLUGIN_API Homecorrupter::setActive (TBool state)
     else
         sendTextMessage( "Homecorrupter::setActive (false)" );
 
-    // reset output level meter
-    outputGainOld = 0.f;
+    // reset output level meters
+    outputGainOld    = 0.f;
+    outputRmsOld     = 0.f;
+    gainReductionOld = 0.f;
+
+    // size the processor to the negotiated bus arrangement (as we're not processing, allocation is safe)
+
+    // as the processor is not processing, the latency affecting settings can be applied (e.g.
+    // when the host restarts the processor after these changed, see PluginController::setParamNormalized())
+
+    applyLatencySettings();
+
+    if ( state ) {
+        AudioBus* bus = FCast<AudioBus>( audioInputs.at( 0 ));
+        if ( bus ) {
+            pluginProcess->setAmountOfChannels( SpeakerArr::getChannelCount( bus->getArrangement()));
+        }
+        pluginProcess->recordingStore.prepare(
+            pluginProcess->getAmountOfChannels(), PluginProcess::MAX_RECORD_SECONDS, VST::SAMPLE_RATE
+        );
+        _deadlineMonitor.reset();
+        _sideChainFollower.setSampleRate( VST::SAMPLE_RATE );
+        _sideChainFollower.reset();
+    }
 
     // call our parent setActive
     return AudioEffect::setActive( state );
@@ -105,6 +130,12 @@ tresult PLUGIN_API Homecorrupter::setActive (TBool state)
 //------------------------------------------------------------------------
 tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
 {
+    // treat denormals as zero for the duration of this process cycle (restored when leaving this scope)
+
+    DenormalGuard denormalGuard;
+
+    _deadlineMonitor.begin();
+
     // In this example there are 4 steps:
     // 1) Read inputs parameters coming from host (in order to adapt our model values)
     // 2) Read inputs events coming from host (note on/off events)
@@ -189,6 +220,63 @@ tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
                             _bypass = value >= 0.5f;
                         }
                         break;
+
+                    case kLfoSyncId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value) == kResultTrue ) {
+                            _lfoSync = value >= 0.5f;
+                        }
+                        break;
+
+                    case kSaveRecordingId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value) == kResultTrue ) {
+                            _saveRecording = value >= 0.5f;
+                        }
+                        break;
+
+                    case kSideChainResampleId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _sideChainResample = ( float ) value;
+                        break;
+
+                    case kSideChainBitDepthId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _sideChainBitDepth = ( float ) value;
+                        break;
+
+                    case kSideChainPlaybackRateId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _sideChainPlaybackRate = ( float ) value;
+                        break;
+
+                    case kInterpolationId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _interpolation = ( float ) value;
+                        break;
+
+                    case kLfoInterpolationId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _lfoInterpolation = value >= 0.5f;
+                        break;
+
+                    case kStableFilterId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            _stableFilter = value >= 0.5f;
+                        break;
+
+                    case kLimiterLookaheadId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            setLatencyParameter( kLimiterLookaheadId, ( float ) value );
+                        break;
+
+                    case kOversamplingId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            setLatencyParameter( kOversamplingId, ( float ) value );
+                        break;
+
+                    case kCleanDownSamplingId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            setLatencyParameter( kCleanDownSamplingId, ( float ) value );
+                        break;
                 }
                 syncModel();
             }
@@ -216,12 +304,15 @@ tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
             pluginProcess->clearBuffer();
         }
 
-        // in case you want to do tempo synchronization with the host
-        /*
-        pluginProcess->setTempo(
-            data.processContext->tempo, data.processContext->timeSigNumerator, data.processContext->timeSigDenominator
-        );
-        */
+        // tempo synchronization with the host, the oscillator phase is derived from the musical
+        // position of the playing sequencer (when stopped, the position is not advancing)
+
+        if ( data.processContext->state & ProcessContext::kTempoValid ) {
+            bool hasPosition = isPlaying && ( data.processContext->state & ProcessContext::kProjectTimeMusicValid );
+            pluginProcess->setTempo(
+                data.processContext->tempo, data.processContext->projectTimeMusic, hasPosition
+            );
+        }
     }
 
     //---2) Read input events-------------
@@ -234,7 +325,8 @@ tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
 
     if ( data.numInputs == 0 || data.numOutputs == 0 )
     {
-        // nothing to do
+        // nothing to do (the parameter changes above still count against the budget)
+        _deadlineMonitor.end( data.numSamples, processSetup.sampleRate );
         return kResultOk;
     }
 
@@ -268,6 +360,10 @@ tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
     }
     else
     {
+        if ( _hasSideChain ) {
+            applySideChain( data );
+        }
+
         // process the incoming sound!
 
         if ( isDoublePrecision ) {
@@ -294,21 +390,23 @@ tresult PLUGIN_API Homecorrupter::process( ProcessData& data )
 
     // output flags
 
-    data.outputs[ 0 ].silenceFlags = isSilentOutput ? (( uint64 ) 1 << numOutChannels ) - 1 : 0;
-
-    // float outputGain = pluginProcess->limiter->getLinearGR();
+    data.outputs[ 0 ].silenceFlags = isSilentOutput ? getSilenceMask( numOutChannels ) : 0;
 
     //---4) Write output parameter changes-----------
-    // IParameterChanges* outParamChanges = data.outputParameterChanges;
-    // // a new value of VuMeter will be sent to the host
-    // // (the host will send it back in sync to our controller for updating our editor)
-    // if ( !isDoublePrecision && outParamChanges && outputGainOld != outputGain ) {
-    //     int32 index = 0;
-    //     IParamValueQueue* paramQueue = outParamChanges->addParameterData( kVuPPMId, index );
-    //     if ( paramQueue )
-    //         paramQueue->addPoint( 0, outputGain, index );
-    // }
-    // outputGainOld = outputGain;
+    // the meter values are sent to the host once per process cycle
+    // (the host will send them back in sync to our controller for updating our editor)
+    // the limiter measures these while applying its gain, so metering requires no additional pass
+
+    IParameterChanges* outParamChanges = data.outputParameterChanges;
+
+    if ( outParamChanges && !_bypass ) {
+        writeMeter( outParamChanges, kVuPPMId,         std::min( 1.f, pluginProcess->limiter->getPeak()), outputGainOld );
+        writeMeter( outParamChanges, kOutputRmsId,     std::min( 1.f, pluginProcess->limiter->getRms()),  outputRmsOld );
+        writeMeter( outParamChanges, kGainReductionId, 1.f - pluginProcess->limiter->getLinearGR(),       gainReductionOld );
+    }
+
+    _deadlineMonitor.end( data.numSamples, processSetup.sampleRate );
+
     return kResultOk;
 }
 
@@ -327,94 +425,63 @@ tresult Homecorrupter::receiveText( const char* text )
 tresult PLUGIN_API Homecorrupter::setState( IBStream* state )
 {
     // called when we load a preset, the model has to be reloaded
+    // parameters that are not present in the state (e.g. when saved by an older version) retain their value
 
-// --- AUTO-GENERATED SETSTATE START
-
-    float savedResampleRate = 0.f;
-    if ( state->read( &savedResampleRate, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedBitDepth = 0.f;
-    if ( state->read( &savedBitDepth, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedPlaybackRate = 0.f;
-    if ( state->read( &savedPlaybackRate, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedResampleLfo = 0.f;
-    if ( state->read( &savedResampleLfo, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedResampleLfoDepth = 0.f;
-    if ( state->read( &savedResampleLfoDepth, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedBitCrushLfo = 0.f;
-    if ( state->read( &savedBitCrushLfo, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedBitCrushLfoDepth = 0.f;
-    if ( state->read( &savedBitCrushLfoDepth, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedPlaybackRateLfo = 0.f;
-    if ( state->read( &savedPlaybackRateLfo, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedPlaybackRateLfoDepth = 0.f;
-    if ( state->read( &savedPlaybackRateLfoDepth, sizeof ( float )) != kResultOk )
-        return kResultFalse;
-
-    float savedWetMix = 0.f;
-    if ( state->read( &savedWetMix, sizeof ( float )) != kResultOk )
+    PluginState pluginState;
+    if ( !pluginState.read( state ))
         return kResultFalse;
 
-    float savedDryMix = 0.f;
-    if ( state->read( &savedDryMix, sizeof ( float )) != kResultOk )
-        return kResultFalse;
+// --- AUTO-GENERATED SETSTATE START
+    pluginState.getParameter( kResampleRateId, fResampleRate );
+    pluginState.getParameter( kBitDepthId, fBitDepth );
+    pluginState.getParameter( kPlaybackRateId, fPlaybackRate );
+    pluginState.getParameter( kResampleLfoId, fResampleLfo );
+    pluginState.getParameter( kResampleLfoDepthId, fResampleLfoDepth );
+    pluginState.getParameter( kBitCrushLfoId, fBitCrushLfo );
+    pluginState.getParameter( kBitCrushLfoDepthId, fBitCrushLfoDepth );
+    pluginState.getParameter( kPlaybackRateLfoId, fPlaybackRateLfo );
+    pluginState.getParameter( kPlaybackRateLfoDepthId, fPlaybackRateLfoDepth );
+    pluginState.getParameter( kWetMixId, fWetMix );
+    pluginState.getParameter( kDryMixId, fDryMix );
 
 // --- AUTO-GENERATED SETSTATE END
 
-    int32 savedBypass = 0;
-    if ( state->read( &savedBypass, sizeof ( int32 )) != kResultOk )
-        return kResultFalse;
-
-#if BYTEORDER == kBigEndian
-
-// --- AUTO-GENERATED SETSTATE SWAP START
-   SWAP_32( savedResampleRate )
-   SWAP_32( savedBitDepth )
-   SWAP_32( savedPlaybackRate )
-   SWAP_32( savedResampleLfo )
-   SWAP_32( savedResampleLfoDepth )
-   SWAP_32( savedBitCrushLfo )
-   SWAP_32( savedBitCrushLfoDepth )
-   SWAP_32( savedPlaybackRateLfo )
-   SWAP_32( savedPlaybackRateLfoDepth )
-   SWAP_32( savedWetMix )
-   SWAP_32( savedDryMix )
-
-// --- AUTO-GENERATED SETSTATE SWAP END
-
-#endif
-
-// --- AUTO-GENERATED SETSTATE APPLY START
-    fResampleRate = savedResampleRate;
-    fBitDepth = savedBitDepth;
-    fPlaybackRate = savedPlaybackRate;
-    fResampleLfo = savedResampleLfo;
-    fResampleLfoDepth = savedResampleLfoDepth;
-    fBitCrushLfo = savedBitCrushLfo;
-    fBitCrushLfoDepth = savedBitCrushLfoDepth;
-    fPlaybackRateLfo = savedPlaybackRateLfo;
-    fPlaybackRateLfoDepth = savedPlaybackRateLfoDepth;
-    fWetMix = savedWetMix;
-    fDryMix = savedDryMix;
-
-// --- AUTO-GENERATED SETSTATE APPLY END
-
-    _bypass = savedBypass > 0;
+    float savedBypass        = _bypass ? 1.f : 0.f;
+    float savedLfoSync       = _lfoSync ? 1.f : 0.f;
+    float savedSaveRecording = _saveRecording ? 1.f : 0.f;
+    float savedLookahead     = _limiterLookahead ? 1.f : 0.f;
+    float savedClean         = _cleanDownSampling ? 1.f : 0.f;
+    float savedLfoSmoothing  = _lfoInterpolation ? 1.f : 0.f;
+    float savedStableFilter  = _stableFilter ? 1.f : 0.f;
+    float savedOversampling  = oversamplingToNormalized( _oversampling );
+
+    pluginState.getParameter( kBypassId, savedBypass );
+    pluginState.getParameter( kLfoSyncId, savedLfoSync );
+    pluginState.getParameter( kSaveRecordingId, savedSaveRecording );
+    pluginState.getParameter( kSideChainResampleId, _sideChainResample );
+    pluginState.getParameter( kSideChainBitDepthId, _sideChainBitDepth );
+    pluginState.getParameter( kSideChainPlaybackRateId, _sideChainPlaybackRate );
+    pluginState.getParameter( kLimiterLookaheadId, savedLookahead );
+    pluginState.getParameter( kCleanDownSamplingId, savedClean );
+    pluginState.getParameter( kOversamplingId, savedOversampling );
+    pluginState.getParameter( kInterpolationId, _interpolation );
+    pluginState.getParameter( kLfoInterpolationId, savedLfoSmoothing );
+    pluginState.getParameter( kStableFilterId, savedStableFilter );
+
+    _bypass        = savedBypass >= .5f;
+    _lfoSync       = savedLfoSync >= .5f;
+    _saveRecording = savedSaveRecording >= .5f;
+    _lfoInterpolation  = savedLfoSmoothing >= .5f;
+    _stableFilter      = savedStableFilter >= .5f;
+
+    setLatencyParameter( kLimiterLookaheadId, savedLookahead );
+    setLatencyParameter( kOversamplingId, savedOversampling );
+    setLatencyParameter( kCleanDownSamplingId, savedClean );
+
+    // restore the recording (when saved), this is decoded here and applied on the next process cycles
+
+    if ( const std::vector<uint8_t>* recording = pluginState.getChunk( PluginState::RECORDING_CHUNK ))
+        pluginProcess->recordingStore.load( recording->data(), ( uint32_t ) recording->size());
 
     syncModel();
 
@@ -456,62 +523,41 @@ tresult PLUGIN_API Homecorrupter::getState( IBStream* state )
 {
     // here we save the model values
 
+    PluginState pluginState;
+
 // --- AUTO-GENERATED GETSTATE START
-    float toSaveResampleRate = fResampleRate;
-    float toSaveBitDepth = fBitDepth;
-    float toSavePlaybackRate = fPlaybackRate;
-    float toSaveResampleLfo = fResampleLfo;
-    float toSaveResampleLfoDepth = fResampleLfoDepth;
-    float toSaveBitCrushLfo = fBitCrushLfo;
-    float toSaveBitCrushLfoDepth = fBitCrushLfoDepth;
-    float toSavePlaybackRateLfo = fPlaybackRateLfo;
-    float toSavePlaybackRateLfoDepth = fPlaybackRateLfoDepth;
-    float toSaveWetMix = fWetMix;
-    float toSaveDryMix = fDryMix;
+    pluginState.setParameter( kResampleRateId, fResampleRate );
+    pluginState.setParameter( kBitDepthId, fBitDepth );
+    pluginState.setParameter( kPlaybackRateId, fPlaybackRate );
+    pluginState.setParameter( kResampleLfoId, fResampleLfo );
+    pluginState.setParameter( kResampleLfoDepthId, fResampleLfoDepth );
+    pluginState.setParameter( kBitCrushLfoId, fBitCrushLfo );
+    pluginState.setParameter( kBitCrushLfoDepthId, fBitCrushLfoDepth );
+    pluginState.setParameter( kPlaybackRateLfoId, fPlaybackRateLfo );
+    pluginState.setParameter( kPlaybackRateLfoDepthId, fPlaybackRateLfoDepth );
+    pluginState.setParameter( kWetMixId, fWetMix );
+    pluginState.setParameter( kDryMixId, fDryMix );
 
 // --- AUTO-GENERATED GETSTATE END
 
-    int32 toSaveBypass = _bypass ? 1 : 0;
-
-#if BYTEORDER == kBigEndian
-
-// --- AUTO-GENERATED GETSTATE SWAP START
-   SWAP_32( toSaveResampleRate )
-   SWAP_32( toSaveBitDepth )
-   SWAP_32( toSavePlaybackRate )
-   SWAP_32( toSaveResampleLfo )
-   SWAP_32( toSaveResampleLfoDepth )
-   SWAP_32( toSaveBitCrushLfo )
-   SWAP_32( toSaveBitCrushLfoDepth )
-   SWAP_32( toSavePlaybackRateLfo )
-   SWAP_32( toSavePlaybackRateLfoDepth )
-   SWAP_32( toSaveWetMix )
-   SWAP_32( toSaveDryMix )
-
-// --- AUTO-GENERATED GETSTATE SWAP END
-
-    SWAP_32( toSaveBypass );
-
-#endif
-
-// --- AUTO-GENERATED GETSTATE APPLY START
-    state->write( &toSaveResampleRate, sizeof( float ));
-    state->write( &toSaveBitDepth, sizeof( float ));
-    state->write( &toSavePlaybackRate, sizeof( float ));
-    state->write( &toSaveResampleLfo, sizeof( float ));
-    state->write( &toSaveResampleLfoDepth, sizeof( float ));
-    state->write( &toSaveBitCrushLfo, sizeof( float ));
-    state->write( &toSaveBitCrushLfoDepth, sizeof( float ));
-    state->write( &toSavePlaybackRateLfo, sizeof( float ));
-    state->write( &toSavePlaybackRateLfoDepth, sizeof( float ));
-    state->write( &toSaveWetMix, sizeof( float ));
-    state->write( &toSaveDryMix, sizeof( float ));
-
-// --- AUTO-GENERATED GETSTATE APPLY END
-
-    state->write( &toSaveBypass, sizeof( int32 ));
-
-    return kResultOk;
+    pluginState.setParameter( kBypassId, _bypass ? 1.f : 0.f );
+    pluginState.setParameter( kLfoSyncId, _lfoSync ? 1.f : 0.f );
+    pluginState.setParameter( kSaveRecordingId, _saveRecording ? 1.f : 0.f );
+    pluginState.setParameter( kSideChainResampleId, _sideChainResample );
+    pluginState.setParameter( kSideChainBitDepthId, _sideChainBitDepth );
+    pluginState.setParameter( kSideChainPlaybackRateId, _sideChainPlaybackRate );
+    pluginState.setParameter( kLimiterLookaheadId, _limiterLookahead ? 1.f : 0.f );
+    pluginState.setParameter( kCleanDownSamplingId, _cleanDownSampling ? 1.f : 0.f );
+    pluginState.setParameter( kOversamplingId, oversamplingToNormalized( _oversampling ));
+    pluginState.setParameter( kInterpolationId, _interpolation );
+    pluginState.setParameter( kLfoInterpolationId, _lfoInterpolation ? 1.f : 0.f );
+    pluginState.setParameter( kStableFilterId, _stableFilter ? 1.f : 0.f );
+
+    std::vector<uint8_t> recording;
+    if ( _saveRecording && pluginProcess->recordingStore.save( recording ))
+        pluginState.setChunk( PluginState::RECORDING_CHUNK, std::move( recording ));
+
+    return pluginState.write( state ) ? kResultOk : kResultFalse;
 }
 
 //------------------------------------------------------------------------
@@ -524,6 +570,18 @@ tresult PLUGIN_API Homecorrupter::setupProcessing( ProcessSetup& newSetup )
 
     VST::SAMPLE_RATE = newSetup.sampleRate;
 
+    // when rendering offline, we're not bound to a real-time deadline and can spread the channels over multiple cores
+    // (this only applies to wide channel layouts, stereo buses remain processed by the host thread)
+
+    pluginProcess->setMultiThreaded( currentProcessMode == kOffline );
+
+#ifdef HC_DETERMINISTIC_OFFLINE
+    // offline renders (e.g. bounces) should not vary with the block size the host renders in. Note that as
+    // the deterministic mode reads the recording at a different position, bounces will not match real-time playback
+
+    pluginProcess->setDeterministic( currentProcessMode == kOffline );
+#endif
+
     syncModel();
 
     return AudioEffect::setupProcessing( newSetup );
@@ -532,60 +590,75 @@ tresult PLUGIN_API Homecorrupter::setupProcessing( ProcessSetup& newSetup )
 //------------------------------------------------------------------------
 tresult PLUGIN_API Homecorrupter::setBusArrangements( SpeakerArrangement* inputs, int32 numIns, SpeakerArrangement* outputs, int32 numOuts )
 {
-    bool isMonoInOut   = SpeakerArr::getChannelCount( inputs[ 0 ]) == 1 && SpeakerArr::getChannelCount( outputs[ 0 ]) == 1;
-    bool isStereoInOut = SpeakerArr::getChannelCount( inputs[ 0 ]) == 2 && SpeakerArr::getChannelCount( outputs[ 0 ]) == 2;
+    int32 numInChannels  = numIns  > 0 ? SpeakerArr::getChannelCount( inputs[ 0 ])  : 0;
+    int32 numOutChannels = numOuts > 0 ? SpeakerArr::getChannelCount( outputs[ 0 ]) : 0;
+
+    // we support any arrangement where input and output are equal (mono, stereo, but also
+    // surround and ambisonic formats) as each channel is processed individually
+
+    bool isSymmetricInOut = numInChannels > 0 && numInChannels == numOutChannels;
 #ifdef BUILD_AUDIO_UNIT
-    if ( !isMonoInOut && !isStereoInOut ) {
+    if ( !isSymmetricInOut ) {
         return AudioEffect::setBusArrangements( inputs, numIns, outputs, numOuts ); // solves auval 4099 error
     }
 #endif
-    if ( numIns == 1 && numOuts == 1 )
+    // the side chain input (when provided) is only analysed for its level, so any arrangement is accepted
+
+    int32 numMainIns = _hasSideChain ? 2 : 1;
+    SpeakerArrangement sideChainArrangement = numIns > 1 ? inputs[ 1 ] : SpeakerArr::kStereo;
+
+    if ( numIns == numMainIns && numOuts == 1 )
     {
-        if ( isMonoInOut )
-        {
-            AudioBus* bus = FCast<AudioBus>( audioInputs.at( 0 ));
-            if ( bus )
-            {
-                // check if we are Mono => Mono, if not we need to recreate the buses
-                if ( bus->getArrangement() != inputs[0])
-                {
-                    removeAudioBusses();
-                    addAudioInput ( STR16( "Mono In" ),  inputs [ 0 ] );
-                    addAudioOutput( STR16( "Mono Out" ), outputs[ 0 ] );
-                }
-                return kResultOk;
-            }
-        }
-        // the host wants something else than Mono => Mono, in this case we are always Stereo => Stereo
-        else
+        AudioBus* bus = FCast<AudioBus>( audioInputs.at( 0 ));
+        if ( bus )
         {
-            AudioBus* bus = FCast<AudioBus>( audioInputs.at( 0 ));
-            if ( bus )
+            if ( isSymmetricInOut )
             {
-                // the host wants 2->2 (could be LsRs -> LsRs)
-                if ( isStereoInOut )
+                // check if the arrangement differs from the current one, if so we need to recreate the buses
+                if ( bus->getArrangement() != inputs[ 0 ])
                 {
                     removeAudioBusses();
-                    addAudioInput  ( STR16( "Stereo In"),  inputs [ 0 ] );
-                    addAudioOutput ( STR16( "Stereo Out"), outputs[ 0 ]);
-                    
-                    return kResultTrue;
+
+                    if ( numInChannels == 1 ) {
+                        addAudioInput ( STR16( "Mono In" ),  inputs [ 0 ] );
+                        addAudioOutput( STR16( "Mono Out" ), outputs[ 0 ] );
+                    } else if ( numInChannels == 2 ) {
+                        addAudioInput ( STR16( "Stereo In" ),  inputs [ 0 ] );
+                        addAudioOutput( STR16( "Stereo Out" ), outputs[ 0 ] );
+                    } else {
+                        addAudioInput ( STR16( "Multichannel In" ),  inputs [ 0 ] );
+                        addAudioOutput( STR16( "Multichannel Out" ), outputs[ 0 ] );
+                    }
+                    addSideChainInput( sideChainArrangement );
                 }
-                // the host wants something different than 1->1 or 2->2 : in this case we want stereo
-                else if ( bus->getArrangement() != SpeakerArr::kStereo )
+                else if ( _hasSideChain )
                 {
-                    removeAudioBusses();
-                    addAudioInput ( STR16( "Stereo In"),  SpeakerArr::kStereo );
-                    addAudioOutput( STR16( "Stereo Out"), SpeakerArr::kStereo );
-                    
-                    return kResultFalse;
+                    AudioBus* sideChainBus = FCast<AudioBus>( audioInputs.at( 1 ));
+                    if ( sideChainBus ) {
+                        sideChainBus->setArrangement( sideChainArrangement );
+                    }
                 }
+                return kResultTrue;
+            }
+            // the host wants an asymmetric arrangement : in this case we want stereo
+            else if ( bus->getArrangement() != SpeakerArr::kStereo )
+            {
+                removeAudioBusses();
+                addAudioInput ( STR16( "Stereo In"),  SpeakerArr::kStereo );
+                addAudioOutput( STR16( "Stereo Out"), SpeakerArr::kStereo );
+                addSideChainInput( sideChainArrangement );
             }
         }
     }
     return kResultFalse;
 }
 
+//------------------------------------------------------------------------
+uint32 PLUGIN_API Homecorrupter::getLatencySamples()
+{
+    return ( uint32 ) pluginProcess->getLatency();
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API Homecorrupter::canProcessSampleSize( int32 symbolicSampleSize )
 {
@@ -605,6 +678,84 @@ tresult PLUGIN_API Homecorrupter::notify( IMessage* message )
     if ( !message )
         return kInvalidArgument;
 
+    // the controller periodically requests the deadline statistics, these are sent in response
+    // (from the UI thread, as the process thread shouldn't allocate and send messages)
+
+    if ( !strcmp( message->getMessageID(), DeadlineMonitor::REQUEST_MESSAGE ))
+    {
+        if ( IPtr<IMessage> response = owned( allocateMessage()))
+        {
+            DeadlineMonitor::Statistics statistics = _deadlineMonitor.getStatistics();
+
+            response->setMessageID( DeadlineMonitor::STATISTICS_MESSAGE );
+            response->getAttributes()->setBinary( DeadlineMonitor::STATISTICS_DATA, &statistics, sizeof( DeadlineMonitor::Statistics ));
+            sendMessage( response );
+        }
+        return kResultOk;
+    }
+
+#ifdef HC_PROFILE
+    // the same applies to the cycles spent in each stage of the process cycle
+
+    if ( !strcmp( message->getMessageID(), Profiler::REQUEST_MESSAGE ))
+    {
+        if ( IPtr<IMessage> response = owned( allocateMessage()))
+        {
+            Profiler::Report report = pluginProcess->profiler.getReport();
+
+            response->setMessageID( Profiler::REPORT_MESSAGE );
+            response->getAttributes()->setBinary( Profiler::REPORT_DATA, &report, sizeof( Profiler::Report ));
+            sendMessage( response );
+        }
+        return kResultOk;
+    }
+#endif
+
+    // changes to the parameters affecting the latency, applied when the host restarts the processor
+
+    if ( !strcmp( message->getMessageID(), VST::LATENCY_PARAMETER_MESSAGE ))
+    {
+        int64 id;
+        double value;
+        if ( message->getAttributes()->getInt( VST::LATENCY_PARAMETER_ID, id ) == kResultOk &&
+             message->getAttributes()->getFloat( VST::LATENCY_PARAMETER_VALUE, value ) == kResultOk )
+        {
+            setLatencyParameter(( ParamID ) id, ( float ) value );
+        }
+        return kResultOk;
+    }
+
+    // the same applies to the overview of the record buffer, which only copies the most recently published snapshot
+
+    if ( !strcmp( message->getMessageID(), WaveformOverview::REQUEST_MESSAGE ))
+    {
+        if ( IPtr<IMessage> response = owned( allocateMessage()))
+        {
+            const WaveformOverview::Snapshot& snapshot = pluginProcess->waveformOverview.getSnapshot();
+
+            response->setMessageID( WaveformOverview::SNAPSHOT_MESSAGE );
+            response->getAttributes()->setBinary( WaveformOverview::SNAPSHOT_DATA, &snapshot, sizeof( WaveformOverview::Snapshot ));
+            sendMessage( response );
+        }
+        return kResultOk;
+    }
+
+    // the spectra are analyzed upon request, e.g. the analysis takes place on the UI thread
+
+    if ( !strcmp( message->getMessageID(), SpectrumAnalyzer::REQUEST_MESSAGE ))
+    {
+        if ( IPtr<IMessage> response = owned( allocateMessage()))
+        {
+            pluginProcess->spectrumAnalyzer.analyze( VST::SAMPLE_RATE );
+            const SpectrumAnalyzer::Spectrum& spectrum = pluginProcess->spectrumAnalyzer.getSpectrum();
+
+            response->setMessageID( SpectrumAnalyzer::SPECTRUM_MESSAGE );
+            response->getAttributes()->setBinary( SpectrumAnalyzer::SPECTRUM_DATA, &spectrum, sizeof( SpectrumAnalyzer::Spectrum ));
+            sendMessage( response );
+        }
+        return kResultOk;
+    }
+
     if ( !strcmp( message->getMessageID(), "BinaryMessage" ))
     {
         const void* data;
@@ -623,22 +774,39 @@ tresult PLUGIN_API Homecorrupter::notify( IMessage* message )
     return AudioEffect::notify( message );
 }
 
+void Homecorrupter::writeMeter( IParameterChanges* outParamChanges, ParamID id, float value, float& lastValue )
+{
+    if ( value == lastValue ) {
+        return;
+    }
+
+    int32 index = 0;
+    IParamValueQueue* paramQueue = outParamChanges->addParameterData( id, index );
+    if ( paramQueue ) {
+        paramQueue->addPoint( 0, value, index );
+    }
+    lastValue = value;
+}
+
 void Homecorrupter::syncModel()
 {
     // forward the protected model values onto the plugin process and related processors
 
     pluginProcess->setResampleRate( fResampleRate );
-    pluginProcess->bitCrusher->setAmount( fBitDepth );
+    syncBitDepth( fBitDepth );
     pluginProcess->setPlaybackRate( fPlaybackRate );
+    pluginProcess->setTransposedFilter( _stableFilter );
 
-    // note we attenuate the signal at lower bit depths as the dynamic range decreases and volume builds up
-    if ( fBitDepth == 1.f ) {
-        pluginProcess->bitCrusher->setOutputMix( 1.f );
-    } else {
-        pluginProcess->bitCrusher->setOutputMix( fBitDepth > .4f ? 1.25f : .25f );
-    }
+    // the interpolation parameter is a list of the Interpolator::Quality values
+
+    pluginProcess->setInterpolationQuality(( Interpolator::Quality ) std::min(
+        ( int ) Interpolator::SINC, ( int ) round( _interpolation * ( float ) Interpolator::SINC )
+    ));
 
     // oscillators
+    pluginProcess->setTempoSync( _lfoSync );
+    pluginProcess->setLfoInterpolation( _lfoInterpolation );
+    pluginProcess->recordingStore.setEnabled( _saveRecording );
     pluginProcess->setResampleLfo( fResampleLfo, fResampleLfoDepth );
     pluginProcess->setPlaybackRateLfo( fPlaybackRateLfo, fPlaybackRateLfoDepth );
     pluginProcess->bitCrusher->setLFO( fBitCrushLfo, fBitCrushLfoDepth );
@@ -648,4 +816,118 @@ void Homecorrupter::syncModel()
     pluginProcess->setWetMix( fWetMix );
 }
 
+void Homecorrupter::setLatencyParameter( ParamID id, float value )
+{
+    switch ( id )
+    {
+        case kLimiterLookaheadId:
+            _limiterLookahead = value >= .5f;
+            break;
+
+        // the oversampling parameter is a list of the factors 1, 2 and 4
+
+        case kOversamplingId:
+            _oversampling = value < .25f ? 1 : ( value < .75f ? 2 : 4 );
+            break;
+
+        case kCleanDownSamplingId:
+            _cleanDownSampling = value >= .5f;
+            break;
+    }
+}
+
+float Homecorrupter::oversamplingToNormalized( int factor )
+{
+    return factor >= 4 ? 1.f : ( factor == 2 ? .5f : 0.f );
+}
+
+uint64 Homecorrupter::getSilenceMask( int32 numChannels )
+{
+    // shifting by the width of the type is undefined, hence the full mask is returned directly
+
+    return numChannels >= 64 ? ~( uint64 ) 0 : (( uint64 ) 1 << numChannels ) - 1;
+}
+
+void Homecorrupter::applyLatencySettings()
+{
+    pluginProcess->setOversampling( _oversampling );
+    pluginProcess->limiter->setLookahead( _limiterLookahead ? LIMITER_LOOKAHEAD_MS : 0.f );
+    pluginProcess->setCleanDownSampling( _cleanDownSampling );
+}
+
+void Homecorrupter::syncBitDepth( float value )
+{
+    pluginProcess->bitCrusher->setAmount( value );
+    pluginProcess->bitCrusher->setOutputMix( getBitDepthOutputMix( value ));
+}
+
+float Homecorrupter::getBitDepthOutputMix( float value )
+{
+    // note we attenuate the signal at lower bit depths as the dynamic range decreases and volume builds up
+    if ( value == 1.f ) {
+        return 1.f;
+    }
+    return value > .4f ? 1.25f : .25f;
+}
+
+void Homecorrupter::applySideChain( ProcessData& data )
+{
+    // when no destination is modulated, syncModel() has left the destinations at their unmodulated values
+
+    if ( _sideChainResample == 0.f && _sideChainBitDepth == 0.f && _sideChainPlaybackRate == 0.f ) {
+        return;
+    }
+
+    // the side chain buffers are read in place from the host, when the bus is inactive (or all of
+    // its channels are silent) the follower is fed no channels, which releases the envelope
+
+    int32 numChannels = 0;
+    void** sideChain  = nullptr;
+
+    if ( data.numInputs > 1 && audioInputs.at( 1 )->isActive()) {
+        AudioBusBuffers& buffers = data.inputs[ 1 ];
+        bool isSilent = buffers.numChannels > 0 && buffers.silenceFlags == getSilenceMask( buffers.numChannels );
+
+        if ( buffers.numChannels > 0 && !isSilent ) {
+            sideChain   = getChannelBuffersPointer( processSetup, buffers );
+            numChannels = sideChain != nullptr ? buffers.numChannels : 0;
+        }
+    }
+
+    // the envelope lowers each destination from its current value. The envelope is updated at control rate, each
+    // update is scheduled to apply from the sample following its control period (an update at the end of the
+    // process cycle thus applies from the start of the next cycle, as the current envelope is applied first)
+
+    float envelope = _sideChainFollower.getEnvelope();
+    int32 offset   = 0;
+
+    while ( offset < data.numSamples ) {
+        float bitDepth = fBitDepth * ( 1.f - _sideChainBitDepth * envelope );
+
+        pluginProcess->scheduleRates(
+            offset,
+            fResampleRate * ( 1.f - _sideChainResample * envelope ),
+            fPlaybackRate * ( 1.f - _sideChainPlaybackRate * envelope )
+        );
+        pluginProcess->bitCrusher->scheduleAmount( offset, bitDepth, getBitDepthOutputMix( bitDepth ));
+
+        int32 length = std::min( data.numSamples - offset, ( int32 ) _sideChainFollower.getSamplesUntilTick() );
+
+        envelope = data.symbolicSampleSize == kSample64
+            ? _sideChainFollower.process<double>(( double** ) sideChain, numChannels, length, offset )
+            : _sideChainFollower.process<float> (( float** )  sideChain, numChannels, length, offset );
+
+        offset += length;
+    }
+}
+
+void Homecorrupter::addSideChainInput( SpeakerArrangement arrangement )
+{
+    // the side chain is an auxiliary input the host activates on demand
+
+    if ( _hasSideChain ) {
+        addAudioInput( STR16( "Sidechain" ), arrangement, kAux, 0 );
+    }
+}
+
 }
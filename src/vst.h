@@ -25,7 +25,10 @@
 
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "plugin_process.h"
+#include "deadlinemonitor.h"
+#include "envelopefollower.h"
 #include "global.h"
+#include <atomic>
 
 using namespace Steinberg::Vst;
 
@@ -37,7 +40,7 @@ namespace Igorski {
 class Homecorrupter : public AudioEffect
 {
     public:
-        Homecorrupter ();
+        Homecorrupter( bool hasSideChain = false );
         virtual ~Homecorrupter(); // do not forget virtual here
 
         //--- ---------------------------------------------------------------------
@@ -45,6 +48,7 @@ class Homecorrupter : public AudioEffect
         // it will be called to create new instances of this Plug-in
         //--- ---------------------------------------------------------------------
         static FUnknown* createInstance( void* /*context*/ ) { return ( IAudioProcessor* ) new Homecorrupter; }
+        static FUnknown* createSideChainInstance( void* /*context*/ ) { return ( IAudioProcessor* ) new Homecorrupter( true ); }
 
         //--- ---------------------------------------------------------------------
         // AudioEffect overrides:
@@ -76,6 +80,9 @@ class Homecorrupter : public AudioEffect
                                                SpeakerArrangement* outputs,
                                                int32 numOuts ) SMTG_OVERRIDE;
 
+        /** Reports the delay introduced by the processor (e.g. the limiters lookahead) */
+        uint32 PLUGIN_API getLatencySamples() SMTG_OVERRIDE;
+
         /** Asks if a given sample size is supported see \ref SymbolicSampleSizes. */
         tresult PLUGIN_API canProcessSampleSize( int32 symbolicSampleSize ) SMTG_OVERRIDE;
 
@@ -103,15 +110,77 @@ class Homecorrupter : public AudioEffect
 // --- AUTO-GENERATED END
 
         float outputGainOld; // for visualizing output gain in DAW
+        float outputRmsOld     = 0.f;
+        float gainReductionOld = 0.f;
         bool _bypass = false;
+        bool _lfoSync = false;
+        bool _saveRecording = false;
+        bool _lfoInterpolation = false;
+        bool _stableFilter = false;
+        float _interpolation = 0.f; // normalized value of the interpolation quality list (see syncModel())
+
+        // the settings affecting the latency of the processor (and requiring allocation) are stored
+        // when received, but only applied while the processor is inactive (see applyLatencySettings())
+        // these can be received from both the process thread and the UI thread (see notify())
+
+        static constexpr float LIMITER_LOOKAHEAD_MS = 1.5f;
+
+        std::atomic<bool> _limiterLookahead{ false };
+        std::atomic<int>  _oversampling{ 1 };
+        std::atomic<bool> _cleanDownSampling{ false };
+
+        // the amount by which the side chain envelope lowers each modulation destination
+
+        float _sideChainResample     = 0.f;
+        float _sideChainBitDepth     = 0.f;
+        float _sideChainPlaybackRate = 0.f;
 
         int32 currentProcessMode;
         Igorski::PluginProcess* pluginProcess;
         bool isPlaying = false;
 
+        // measures the processing time of each block against its real-time budget (see notify())
+
+        DeadlineMonitor _deadlineMonitor;
+
+        // whether this instance provides the (optional) side chain input and the envelope follower analysing it
+
+        bool _hasSideChain;
+        EnvelopeFollower _sideChainFollower;
+
         // synchronize the processors model with UI led changes
 
         void syncModel();
+
+        // stores the value of given parameter affecting the latency, applyLatencySettings() applies
+        // the stored values onto the processor (when inactive, e.g. when the host restarts the processor)
+
+        void setLatencyParameter( ParamID id, float value );
+        void applyLatencySettings();
+
+        static float oversamplingToNormalized( int factor );
+
+        // applies the bit depth onto the bit crusher (including the output attenuation appropriate for the depth)
+
+        void syncBitDepth( float value );
+        float getBitDepthOutputMix( float value );
+
+        // modulates the destinations by the envelope of the side chain input, scheduling the modulated
+        // values for each control period of the upcoming process cycle (see process())
+
+        void applySideChain( ProcessData& data );
+
+        // adds the side chain input bus (when this instance provides one)
+
+        void addSideChainInput( SpeakerArrangement arrangement );
+
+        // writes given meter value into the output parameter changes (when it differs from the last written value)
+
+        void writeMeter( IParameterChanges* outParamChanges, ParamID id, float value, float& lastValue );
+
+        // the silence flags with a bit set for each of given amount of channels (the flags hold up to 64 channels)
+
+        static uint64 getSilenceMask( int32 numChannels );
 };
 
 }
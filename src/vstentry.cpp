@@ -61,6 +61,18 @@ BEGIN_FACTORY_DEF( "igorski.nl",
                 kVstVersionString,               // the VST 3 SDK version (do not change this)
                 Homecorrupter::createInstance )       // function pointer called when this component should be instantiated
 
+    // the same component providing an additional side chain input (a separate class, so existing
+    // instances keep their bus layout and hosts lacking support for auxiliary inputs are unaffected)
+    DEF_CLASS2( INLINE_UID_FROM_FUID( Igorski::VST::PluginWithSideChainProcessorUID ),
+                PClassInfo::kManyInstances,
+                kVstAudioEffectClass,
+                Igorski::VST::NAME_SC,
+                Vst::kDistributable,
+                "Fx",
+                FULL_VERSION_STR,
+                kVstVersionString,
+                Homecorrupter::createSideChainInstance )
+
     // its kVstComponentControllerClass component
     DEF_CLASS2( INLINE_UID_FROM_FUID( Igorski::VST::PluginControllerUID ),
                 PClassInfo::kManyInstances,   // cardinality
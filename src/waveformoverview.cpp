@@ -0,0 +1,136 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "waveformoverview.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+WaveformOverview::WaveformOverview()
+{
+    for ( Snapshot& snapshot : _snapshots ) {
+        snapshot.amountOfBins  = 0;
+        snapshot.readPosition  = 0.f;
+        snapshot.writePosition = 0.f;
+    }
+}
+
+WaveformOverview::~WaveformOverview()
+{
+
+}
+
+/* public methods */
+
+void WaveformOverview::prepare( int recordSize )
+{
+    if ( recordSize == _recordSize ) {
+        return;
+    }
+    _recordSize = recordSize;
+
+    _minimum.clear();
+    _maximum.clear();
+
+    // each level halves the amount of bins of the level below, up until the snapshot resolution
+
+    int amountOfBins = ( recordSize + SAMPLES_PER_BIN - 1 ) / SAMPLES_PER_BIN;
+
+    while ( true ) {
+        _minimum.emplace_back( amountOfBins, 0.f );
+        _maximum.emplace_back( amountOfBins, 0.f );
+
+        if ( amountOfBins <= SNAPSHOT_BINS ) {
+            break;
+        }
+        amountOfBins = ( amountOfBins + 1 ) / 2;
+    }
+}
+
+void WaveformOverview::clear()
+{
+    for ( size_t level = 0; level < _minimum.size(); ++level ) {
+        std::fill( _minimum[ level ].begin(), _minimum[ level ].end(), 0.f );
+        std::fill( _maximum[ level ].begin(), _maximum[ level ].end(), 0.f );
+    }
+}
+
+void WaveformOverview::publish( float readPointer, int writePointer )
+{
+    if ( _samplesSincePublish < PUBLISH_INTERVAL || _recordSize == 0 ) {
+        return;
+    }
+    _samplesSincePublish = 0;
+
+    Snapshot& snapshot = _snapshots[ _writeSnapshot ];
+
+    const std::vector<float>& minimum = _minimum.back();
+    const std::vector<float>& maximum = _maximum.back();
+
+    snapshot.amountOfBins  = ( int ) minimum.size();
+    snapshot.readPosition  = readPointer / ( float ) _recordSize;
+    snapshot.writePosition = ( float ) writePointer / ( float ) _recordSize;
+
+    std::copy( minimum.begin(), minimum.end(), snapshot.minimum );
+    std::copy( maximum.begin(), maximum.end(), snapshot.maximum );
+
+    // make the written snapshot the latest, continuing with the previously latest one
+
+    _writeSnapshot = _latestSnapshot.exchange( _writeSnapshot | SNAPSHOT_FRESH, std::memory_order_acq_rel ) & ~SNAPSHOT_FRESH;
+}
+
+const WaveformOverview::Snapshot& WaveformOverview::getSnapshot()
+{
+    // when a new snapshot has been published, exchange it with the one currently held by the reader
+
+    if ( _latestSnapshot.load( std::memory_order_acquire ) & SNAPSHOT_FRESH ) {
+        _readSnapshot = _latestSnapshot.exchange( _readSnapshot, std::memory_order_acq_rel ) & ~SNAPSHOT_FRESH;
+    }
+    return _snapshots[ _readSnapshot ];
+}
+
+/* private methods */
+
+void WaveformOverview::updateLevels( int bin )
+{
+    for ( size_t level = 1; level < _minimum.size(); ++level ) {
+        const std::vector<float>& childMinimum = _minimum[ level - 1 ];
+        const std::vector<float>& childMaximum = _maximum[ level - 1 ];
+
+        int child = bin & ~1;
+        bin >>= 1;
+
+        // the last bin of a level can have a single child
+
+        if ( child + 1 < ( int ) childMinimum.size()) {
+            _minimum[ level ][ bin ] = std::min( childMinimum[ child ], childMinimum[ child + 1 ]);
+            _maximum[ level ][ bin ] = std::max( childMaximum[ child ], childMaximum[ child + 1 ]);
+        } else {
+            _minimum[ level ][ bin ] = childMinimum[ child ];
+            _maximum[ level ][ bin ] = childMaximum[ child ];
+        }
+    }
+}
+
+}
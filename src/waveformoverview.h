@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WAVEFORMOVERVIEW_H_INCLUDED__
+#define __WAVEFORMOVERVIEW_H_INCLUDED__
+
+#include <atomic>
+#include <vector>
+
+namespace Igorski {
+/**
+ * A WaveformOverview keeps a min/max pyramid of the contents of the (circular) record buffer, for display in the editor.
+ *
+ * The pyramid is updated incrementally by the process thread while recording (see write()) where each level
+ * halves the resolution of the level below it. Periodically, the coarsest level is published into a snapshot
+ * which the UI thread can read without locking or waiting (see getSnapshot()), meaning the UI never accesses
+ * the record buffer and the process thread does no additional work when the UI redraws.
+ */
+class WaveformOverview
+{
+    public:
+        static constexpr int SAMPLES_PER_BIN = 64;   // resolution of the finest level of the pyramid
+        static constexpr int SNAPSHOT_BINS   = 512;  // the maximum resolution of the published snapshot
+        static constexpr int PUBLISH_INTERVAL = 1024; // minimum amount of recorded samples between snapshots
+
+        // messages exchanged with the controller, the controller requests the snapshot
+        // which is sent in response (as the process thread should not send messages)
+
+        static constexpr const char* REQUEST_MESSAGE  = "WaveformSnapshotRequest";
+        static constexpr const char* SNAPSHOT_MESSAGE = "WaveformSnapshot";
+        static constexpr const char* SNAPSHOT_DATA    = "Snapshot"; // binary attribute holding the Snapshot
+
+        struct Snapshot {
+            int amountOfBins;
+            float readPosition;  // position of the read pointer relative to the record buffer size (0 - 1 range)
+            float writePosition; // position of the write pointer relative to the record buffer size (0 - 1 range)
+            float minimum[ SNAPSHOT_BINS ];
+            float maximum[ SNAPSHOT_BINS ];
+        };
+
+        WaveformOverview();
+        ~WaveformOverview();
+
+        // (re)creates the pyramid for a record buffer of given size (when it differs from the current size)
+
+        void prepare( int recordSize );
+
+        // empties the pyramid (e.g. when the record buffer is cleared)
+
+        void clear();
+
+        // updates the pyramid for given amount of samples of given channels, which are written into
+        // the record buffer at given position (wrapping around the end of the record buffer)
+
+        template <typename SampleType>
+        void write( SampleType** channels, int numChannels, int position, int length );
+
+        // publishes the coarsest level of the pyramid and the given positions of the read and write
+        // pointers (as record buffer indices) into a new snapshot, when the PUBLISH_INTERVAL has passed
+
+        void publish( float readPointer, int writePointer );
+
+        // retrieves the most recently published snapshot (for use by a single reading thread)
+
+        const Snapshot& getSnapshot();
+
+    private:
+        int _recordSize = 0;
+        int _samplesSincePublish = 0;
+
+        // the minimum and maximum value of each bin, for each level of the pyramid
+
+        std::vector<std::vector<float>> _minimum;
+        std::vector<std::vector<float>> _maximum;
+
+        // recalculates the bins of all levels above the given bin of the finest level
+
+        void updateLevels( int bin );
+
+        // the snapshots are triple buffered: the process thread writes into one while the reader
+        // holds another, the third being the most recently published (exchanged atomically)
+
+        static constexpr int SNAPSHOT_FRESH = 4; // flags the latest snapshot as not yet retrieved by the reader
+
+        Snapshot _snapshots[ 3 ];
+        int _writeSnapshot = 0;
+        int _readSnapshot  = 1;
+        std::atomic<int> _latestSnapshot{ 2 };
+};
+}
+
+#include "waveformoverview.tcc"
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+template <typename SampleType>
+void WaveformOverview::write( SampleType** channels, int numChannels, int position, int length )
+{
+    if ( _recordSize == 0 || numChannels == 0 ) {
+        return;
+    }
+    std::vector<float>& minimum = _minimum[ 0 ];
+    std::vector<float>& maximum = _maximum[ 0 ];
+
+    int offset = 0;
+    _samplesSincePublish += length;
+
+    // process the samples in runs that lie within the same bin
+
+    while ( offset < length ) {
+        if ( position >= _recordSize ) {
+            position = 0;
+        }
+        int bin    = position / SAMPLES_PER_BIN;
+        int binEnd = std::min(( bin + 1 ) * SAMPLES_PER_BIN, _recordSize );
+        int count  = std::min( length - offset, binEnd - position );
+
+        // when the recording starts at the beginning of a bin, its previous contents are overwritten
+
+        SampleType low  = channels[ 0 ][ offset ];
+        SampleType high = low;
+
+        if ( position != bin * SAMPLES_PER_BIN ) {
+            low  = ( SampleType ) minimum[ bin ];
+            high = ( SampleType ) maximum[ bin ];
+        }
+
+        for ( int c = 0; c < numChannels; ++c ) {
+            const SampleType* channel = channels[ c ] + offset;
+
+            for ( int i = 0; i < count; ++i ) {
+                low  = std::min( low,  channel[ i ]);
+                high = std::max( high, channel[ i ]);
+            }
+        }
+        minimum[ bin ] = ( float ) low;
+        maximum[ bin ] = ( float ) high;
+
+        updateLevels( bin );
+
+        position += count;
+        offset   += count;
+    }
+}
+
+}
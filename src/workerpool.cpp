@@ -0,0 +1,120 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "workerpool.h"
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+WorkerPool::WorkerPool( int amountOfWorkers )
+{
+    _nextTask.store( 0 );
+
+    for ( int i = 0; i < amountOfWorkers; ++i ) {
+        _workers.emplace_back( &WorkerPool::work, this );
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _running = false;
+    }
+    _startCondition.notify_all();
+
+    for ( std::thread& worker : _workers ) {
+        worker.join();
+    }
+}
+
+/* public methods */
+
+int WorkerPool::getAmountOfWorkers()
+{
+    return ( int ) _workers.size();
+}
+
+void WorkerPool::run( Task task, void* context, int amountOfTasks )
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        _task          = task;
+        _context       = context;
+        _amountOfTasks = amountOfTasks;
+        _activeWorkers = ( int ) _workers.size();
+        _nextTask.store( 0 );
+
+        ++_generation;
+    }
+    _startCondition.notify_all();
+
+    // the calling thread participates in executing the tasks
+
+    executeTasks();
+
+    // wait until all workers have finished (note a worker might still be executing a task)
+
+    std::unique_lock<std::mutex> lock( _mutex );
+    _doneCondition.wait( lock, [ this ] { return _activeWorkers == 0; });
+}
+
+/* private methods */
+
+void WorkerPool::work()
+{
+    unsigned int generation = 0;
+
+    while ( true )
+    {
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _startCondition.wait( lock, [ this, generation ] { return !_running || _generation != generation; });
+
+            if ( !_running ) {
+                return;
+            }
+            generation = _generation;
+        }
+
+        executeTasks();
+
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            if ( --_activeWorkers == 0 ) {
+                _doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::executeTasks()
+{
+    int index;
+    while (( index = _nextTask.fetch_add( 1 )) < _amountOfTasks ) {
+        _task( _context, index );
+    }
+}
+
+}
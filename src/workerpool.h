@@ -0,0 +1,78 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WORKERPOOL_H_INCLUDED__
+#define __WORKERPOOL_H_INCLUDED__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Igorski {
+/**
+ * A WorkerPool holds a fixed amount of persistent threads that can
+ * execute a batch of (independent) tasks in parallel. Threads are created
+ * upon construction so no allocation or thread creation takes place when running tasks.
+ */
+class WorkerPool
+{
+    public:
+        static constexpr int MAX_WORKERS = 15;
+
+        // a task receives the context provided to run() and the index of the task to execute
+
+        typedef void ( *Task )( void* context, int index );
+
+        WorkerPool( int amountOfWorkers );
+        ~WorkerPool();
+
+        int getAmountOfWorkers();
+
+        /**
+         * executes given task for each index in the 0 - amountOfTasks range, distributed
+         * over the worker threads and the calling thread. Returns once all tasks have completed
+         */
+        void run( Task task, void* context, int amountOfTasks );
+
+    private:
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _startCondition;
+        std::condition_variable _doneCondition;
+
+        Task  _task          = nullptr;
+        void* _context       = nullptr;
+        int   _amountOfTasks = 0;
+        int   _activeWorkers = 0;
+        bool  _running       = true;
+        unsigned int _generation = 0; // incremented for each run, signals the workers to start
+
+        std::atomic<int> _nextTask;
+
+        void work();
+        void executeTasks();
+};
+}
+
+#endif
@@ -0,0 +1,427 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../src/vst.h"
+#include "../src/paramids.h"
+
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+#include "public.sdk/source/vst/hosting/processdata.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+using namespace Igorski;
+
+/**
+ * A headless host that runs instances of the plugin in a simulated real-time context, to measure
+ * how many instances fit within the processing budget of a single core (without requiring an audio interface)
+ *
+ * All instances are processed one after another on a SCHED_FIFO thread (pinned to a single core),
+ * which wakes up on the period of each block (the duration of its samples at the sample rate). Like a real host, it
+ * varies the size of each block (e.g. at loop points), automates parameters and starts and stops the transport.
+ *
+ * usage : realtime_host [--instances N] [--block-size N] [--sample-rate N] [--seconds N] [--jitter 0-1] [--cpu N] [--double] [--side-chain]
+ *
+ * reports the amount of xruns (periods in which processing all instances exceeded the period), the distribution
+ * of the time spent processing a single block of a single instance and the resulting amount of instances per core.
+ * SCHED_FIFO and locking memory require privileges (e.g. root or an rtprio limit in /etc/security/limits.conf)
+ * Exits with code 2 when xruns occurred, so the amount of instances can be raised by a script until this happens.
+ */
+namespace {
+
+struct Options {
+    int    instances  = 8;
+    int    blockSize  = 128;
+    double sampleRate = 44100.0;
+    double seconds    = 10.0;
+    double jitter     = .5;  // the fraction by which the block size varies (block sizes range from blockSize * ( 1 - jitter ) to blockSize)
+    int    cpu        = 0;
+    bool   double64   = false;
+    bool   sideChain  = false; // whether to run the variant with a side chain input
+};
+
+// the parameters automated during the run (excluding those affecting the latency, as these require a restart)
+
+const ParamID AUTOMATED_PARAMETERS[] = {
+    kResampleRateId, kBitDepthId, kPlaybackRateId, kResampleLfoId, kResampleLfoDepthId,
+    kBitCrushLfoId, kBitCrushLfoDepthId, kPlaybackRateLfoId, kPlaybackRateLfoDepthId,
+    kWetMixId, kDryMixId, kInterpolationId, kLfoInterpolationId, kStableFilterId
+};
+const int AMOUNT_OF_AUTOMATED_PARAMETERS = sizeof( AUTOMATED_PARAMETERS ) / sizeof( ParamID );
+
+const int AMOUNT_OF_METERS = 3; // see Homecorrupter::writeMeter()
+
+const double TRANSPORT_INTERVAL = 2.0; // in seconds, the interval at which the transport starts / stops
+
+// the duration (in seconds) processed before measuring, as the processor sizes its buffers in the first process cycles
+
+const double WARM_UP = .5;
+
+struct Instance {
+    Homecorrupter* processor;
+    HostProcessData data;
+    ParameterChanges parameterChanges;
+    ParameterChanges outputParameterChanges; // receives the meters
+    ProcessContext context;
+};
+
+// deterministic noise source (rand() is not guaranteed to be real-time safe)
+
+unsigned int random( unsigned int& seed )
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+double randomNormalized( unsigned int& seed )
+{
+    return ( double ) random( seed ) / ( double ) 0xFFFFFF;
+}
+
+inline uint64_t toNanoseconds( const timespec& time )
+{
+    return ( uint64_t ) time.tv_sec * 1000000000ull + ( uint64_t ) time.tv_nsec;
+}
+
+inline uint64_t now()
+{
+    timespec time;
+    clock_gettime( CLOCK_MONOTONIC, &time );
+    return toNanoseconds( time );
+}
+
+void sleepUntil( uint64_t nanoseconds )
+{
+    timespec time;
+    time.tv_sec  = ( time_t )( nanoseconds / 1000000000ull );
+    time.tv_nsec = ( long )( nanoseconds % 1000000000ull );
+    while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr ) != 0 ) {
+        // interrupted by a signal, sleep the remainder
+    }
+}
+
+bool parseOptions( int argc, char** argv, Options& options )
+{
+    for ( int i = 1; i < argc; ++i ) {
+        std::string name = argv[ i ];
+        if ( name == "--double" ) {
+            options.double64 = true;
+            continue;
+        }
+        if ( name == "--side-chain" ) {
+            options.sideChain = true;
+            continue;
+        }
+        if ( i + 1 >= argc ) {
+            return false;
+        }
+        const char* value = argv[ ++i ];
+        if ( name == "--instances" ) {
+            options.instances = std::max( 1, atoi( value ));
+        } else if ( name == "--block-size" ) {
+            options.blockSize = std::max( 1, atoi( value ));
+        } else if ( name == "--sample-rate" ) {
+            options.sampleRate = std::max( 8000.0, atof( value ));
+        } else if ( name == "--seconds" ) {
+            options.seconds = std::max( .1, atof( value ));
+        } else if ( name == "--jitter" ) {
+            options.jitter = std::min( 1.0, std::max( 0.0, atof( value )));
+        } else if ( name == "--cpu" ) {
+            options.cpu = atoi( value );
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool createInstance( Instance& instance, const Options& options )
+{
+    instance.processor = new Homecorrupter( options.sideChain );
+    if ( instance.processor->initialize( nullptr ) != kResultOk ) {
+        return false;
+    }
+    int32 sampleSize = options.double64 ? kSample64 : kSample32;
+
+    ProcessSetup setup = { kRealtime, sampleSize, options.blockSize, options.sampleRate };
+    if ( instance.processor->setupProcessing( setup ) != kResultOk ) {
+        return false;
+    }
+    if ( !instance.data.prepare( *instance.processor, options.blockSize, sampleSize )) {
+        return false;
+    }
+    instance.parameterChanges.setMaxParameters( AMOUNT_OF_AUTOMATED_PARAMETERS );
+    instance.outputParameterChanges.setMaxParameters( AMOUNT_OF_METERS );
+
+    memset( &instance.context, 0, sizeof( ProcessContext ));
+    instance.context.sampleRate = options.sampleRate;
+    instance.context.tempo      = 120.0;
+
+    instance.data.inputParameterChanges  = &instance.parameterChanges;
+    instance.data.outputParameterChanges = &instance.outputParameterChanges;
+    instance.data.processContext         = &instance.context;
+
+    instance.processor->setActive( true );
+    instance.processor->setProcessing( true );
+
+    return true;
+}
+
+void destroyInstance( Instance& instance )
+{
+    if ( instance.processor == nullptr ) {
+        return;
+    }
+    instance.processor->setProcessing( false );
+    instance.processor->setActive( false );
+    instance.data.unprepare();
+    instance.processor->terminate();
+    instance.processor->release();
+    instance.processor = nullptr;
+}
+
+// prepares the next block of given instance: fills the input with noise, automates all parameters
+// (a ramp for continuous parameters, a toggle for lists and switches) and advances the transport
+
+void prepareBlock( Instance& instance, int index, int numSamples, double position, unsigned int& seed, const Options& options )
+{
+    instance.data.numSamples = numSamples;
+
+    for ( int bus = 0; bus < instance.data.numInputs; ++bus ) {
+        AudioBusBuffers& buffers = instance.data.inputs[ bus ];
+        for ( int c = 0; c < buffers.numChannels; ++c ) {
+            for ( int i = 0; i < numSamples; ++i ) {
+                double sample = randomNormalized( seed ) * .5 - .25;
+                if ( options.double64 ) {
+                    buffers.channelBuffers64[ c ][ i ] = sample;
+                } else {
+                    buffers.channelBuffers32[ c ][ i ] = ( float ) sample;
+                }
+            }
+        }
+        buffers.silenceFlags = 0;
+    }
+
+    instance.parameterChanges.clearQueue();
+    instance.outputParameterChanges.clearQueue();
+    for ( int p = 0; p < AMOUNT_OF_AUTOMATED_PARAMETERS; ++p ) {
+        ParamID id = AUTOMATED_PARAMETERS[ p ];
+        int32 queueIndex, pointIndex;
+        IParamValueQueue* queue = instance.parameterChanges.addParameterData( id, queueIndex );
+        if ( queue == nullptr ) {
+            continue;
+        }
+        // each instance and parameter is offset in phase, so instances aren't processing identical settings
+
+        double phase = position / ( 3.0 + p ) + index * .37;
+        double value = .5 + .5 * sin( phase * VST::TWO_PI );
+        if ( id == kInterpolationId || id == kLfoInterpolationId || id == kStableFilterId ) {
+            value = fmod( floor( phase * 4.0 ), 4.0 ) / 3.0;
+        }
+        queue->addPoint( numSamples - 1, value, pointIndex );
+    }
+
+    // start / stop the transport on a fixed interval, the musical position advances while playing
+
+    ProcessContext& context = instance.context;
+    bool playing = fmod( position + index * .5, TRANSPORT_INTERVAL * 2 ) < TRANSPORT_INTERVAL;
+
+    context.state = ProcessContext::kTempoValid | ProcessContext::kProjectTimeMusicValid | ( playing ? ProcessContext::kPlaying : 0 );
+    if ( playing ) {
+        context.projectTimeMusic     += numSamples / options.sampleRate * ( context.tempo / 60.0 );
+        context.projectTimeSamples   += numSamples;
+    }
+}
+
+// the value at given percentile of given (sorted) durations
+
+uint64_t percentile( const std::vector<uint64_t>& sorted, double percentile )
+{
+    if ( sorted.empty()) {
+        return 0;
+    }
+    size_t index = ( size_t )( percentile / 100.0 * ( double )( sorted.size() - 1 ) + .5 );
+    return sorted[ std::min( index, sorted.size() - 1 )];
+}
+
+void enableRealTime( const Options& options )
+{
+    if ( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 ) {
+        printf( "warning : could not lock memory, page faults can cause xruns\n" );
+    }
+    cpu_set_t cpus;
+    CPU_ZERO( &cpus );
+    CPU_SET( options.cpu, &cpus );
+    if ( pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &cpus ) != 0 ) {
+        printf( "warning : could not pin the process thread to cpu %d\n", options.cpu );
+    }
+    sched_param parameters;
+    parameters.sched_priority = sched_get_priority_max( SCHED_FIFO ) - 10; // below the priority of IRQ threads
+    if ( pthread_setschedparam( pthread_self(), SCHED_FIFO, &parameters ) != 0 ) {
+        printf( "warning : could not enable SCHED_FIFO, measuring with the default scheduling policy\n" );
+    }
+}
+
+}
+
+int main( int argc, char** argv )
+{
+    Options options;
+    if ( !parseOptions( argc, argv, options )) {
+        printf( "usage : %s [--instances N] [--block-size N] [--sample-rate N] [--seconds N] [--jitter 0-1] [--cpu N] [--double] [--side-chain]\n", argv[ 0 ]);
+        return 1;
+    }
+
+    std::vector<Instance> instances( options.instances );
+    for ( Instance& instance : instances ) {
+        instance.processor = nullptr;
+        if ( !createInstance( instance, options )) {
+            printf( "could not create the plugin instance\n" );
+            return 1;
+        }
+    }
+
+    // the period of each block is the duration of its amount of samples. As the block sizes vary (see --jitter),
+    // the durations are reported normalized to a full block, so they relate to the period of a full block
+
+    const uint64_t period      = ( uint64_t )( options.blockSize / options.sampleRate * 1e9 );
+    const double meanBlockSize = options.blockSize - options.jitter * ( options.blockSize - 1 ) / 2.0;
+    const int amountOfPeriods  = ( int ) ceil( options.seconds * options.sampleRate / meanBlockSize );
+    const int warmUpPeriods    = ( int ) ceil( WARM_UP * options.sampleRate / meanBlockSize );
+
+    // all storage is allocated up front, as the process thread should not allocate
+
+    std::vector<uint64_t> blockDurations; // the (normalized) time spent by a single instance processing a single block
+    std::vector<uint64_t> periodDurations; // the (normalized) time spent by all instances in a single period
+    std::vector<uint64_t> wakeUpLatencies; // the time between the start of the period and the thread waking up
+    blockDurations.reserve(( size_t ) amountOfPeriods * options.instances );
+    periodDurations.reserve(( size_t ) amountOfPeriods );
+    wakeUpLatencies.reserve(( size_t ) amountOfPeriods );
+
+    int xruns     = 0;
+    int overloads = 0; // xruns caused by the processing exceeding the period (rather than waking up late)
+    int processedSamples = 0;
+    int measuredSamples  = 0; // the amount of samples processed after the warm up
+    double totalDuration = 0.0;
+    unsigned int seed = 1;
+
+    enableRealTime( options );
+
+    uint64_t nextPeriod = now() + period;
+
+    for ( int p = -warmUpPeriods; p < amountOfPeriods; ++p ) {
+        sleepUntil( nextPeriod );
+        uint64_t wakeUpLatency = now() - nextPeriod;
+
+        int numSamples = options.blockSize - ( int )( randomNormalized( seed ) * options.jitter * ( options.blockSize - 1 ));
+        double position   = processedSamples / options.sampleRate;
+
+        uint64_t blockPeriod = ( uint64_t )( numSamples / options.sampleRate * 1e9 );
+        double normalization = ( double ) options.blockSize / numSamples;
+
+        uint64_t periodDuration = 0;
+
+        for ( int i = 0; i < options.instances; ++i ) {
+            Instance& instance = instances[ i ];
+            prepareBlock( instance, i, numSamples, position, seed, options );
+
+            uint64_t start = now();
+            instance.processor->process( instance.data );
+            uint64_t duration = now() - start;
+
+            if ( p >= 0 ) {
+                blockDurations.push_back(( uint64_t )( duration * normalization ));
+            }
+            periodDuration += duration;
+        }
+        if ( p >= 0 ) {
+            measuredSamples += numSamples;
+            totalDuration   += ( double ) periodDuration;
+            periodDurations.push_back(( uint64_t )( periodDuration * normalization ));
+            wakeUpLatencies.push_back( wakeUpLatency );
+            overloads += periodDuration > blockPeriod ? 1 : 0;
+        }
+        processedSamples += numSamples;
+
+        // when the instances didn't finish within the period, the output would have been late (e.g. an audible dropout)
+        // a real host would skip to the next period (as the current one has passed), so do we
+
+        nextPeriod += blockPeriod;
+        if ( now() > nextPeriod ) {
+            xruns += p >= 0 ? 1 : 0;
+            while ( nextPeriod < now()) {
+                nextPeriod += blockPeriod;
+            }
+        }
+    }
+
+    for ( Instance& instance : instances ) {
+        destroyInstance( instance );
+    }
+
+    std::sort( blockDurations.begin(),  blockDurations.end());
+    std::sort( periodDurations.begin(), periodDurations.end());
+    std::sort( wakeUpLatencies.begin(), wakeUpLatencies.end());
+
+    // the mean is derived from the total time spent on all samples (rather than averaging the normalized
+    // durations) so the fixed cost of small blocks isn't weighted more than that of larger blocks
+
+    double mean = totalDuration / options.instances * options.blockSize / std::max( 1, measuredSamples );
+
+    printf( "%d instance(s), %s, block size %d (jitter %.0f%%) at %.0f Hz, period of %.1f us (for a full block), %d periods\n",
+        options.instances, options.double64 ? "double" : "float", options.blockSize, options.jitter * 100.0,
+        options.sampleRate, period / 1e3, amountOfPeriods
+    );
+    printf( "xruns : %d (%.3f%% of periods), %d due to processing exceeding the period\n",
+        xruns, 100.0 * xruns / amountOfPeriods, overloads
+    );
+    printf( "wake up latency (us) : p50 %.1f, p99 %.1f, max %.1f\n",
+        percentile( wakeUpLatencies, 50 ) / 1e3, percentile( wakeUpLatencies, 99 ) / 1e3, wakeUpLatencies.back() / 1e3
+    );
+
+    printf( "time per block per instance (us, normalized to a full block) : min %.1f, mean %.1f, p50 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+        blockDurations.front() / 1e3, mean / 1e3, percentile( blockDurations, 50 ) / 1e3,
+        percentile( blockDurations, 99 ) / 1e3, percentile( blockDurations, 99.9 ) / 1e3, blockDurations.back() / 1e3
+    );
+    printf( "time per period, all instances (us, normalized to a full block) : p50 %.1f, p99 %.1f, max %.1f (%.1f%% of the period)\n",
+        percentile( periodDurations, 50 ) / 1e3, percentile( periodDurations, 99 ) / 1e3,
+        periodDurations.back() / 1e3, 100.0 * periodDurations.back() / period
+    );
+
+    // the capacity is derived from the worst case (99.9th percentile) rather than the mean, as a single
+    // late block already causes a dropout. A host additionally needs headroom for its own processing
+
+    printf( "instances per core : %.1f (at the mean), %.1f (at p99.9)\n",
+        period / std::max( 1.0, mean ), period / ( double ) std::max(( uint64_t ) 1, percentile( blockDurations, 99.9 ))
+    );
+    return xruns == 0 ? 0 : 2;
+}
@@ -0,0 +1,518 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../src/plugin_process.h"
+#include "../src/denormalguard.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Igorski;
+
+float VST::SAMPLE_RATE = 44100.f; // normally defined in vst.cpp
+
+/**
+ * renders synthetic input through PluginProcess for a set of presets, at several block sizes
+ * and for both floating point types, comparing the output against stored reference renders
+ * (see "Verifying changes to the audio processing" in the README). Additionally verifies that
+ * a recording saved in the plugin state plays back as it did prior to saving, once restored
+ *
+ * the renders are made in both deterministic mode (at all block sizes) and real-time mode (at the block sizes hosts
+ * commonly use, where the output depends on the block size). The real-time renders of the presets that were available
+ * before the optimization of the audio processing are also compared against renders of those sources (see BASELINE_PRESETS)
+ *
+ * usage : render_test <reference folder> [--generate]
+ * where --generate (re)writes the references from the current sources (the baseline references are never rewritten)
+ */
+namespace {
+
+const int   MAX_CHANNELS       = 8;
+const int   FRAMES             = 2048;
+const float TOLERANCE          = 1e-6f; // -120 dBFS, allows for reordered calculations
+
+// a restored recording is stored at 16-bit resolution, its playback settles once the
+// filters have processed the first block after the restore (see testRestore())
+
+const int   RESTORE_BLOCK_SIZE = 512;
+const int   RESTORE_FRAMES     = RecordingStore::RESTORE_BLOCK_SIZE * 3; // recorded prior to saving
+const int   RESTORE_SETTLE     = RESTORE_BLOCK_SIZE;
+const float RESTORE_TOLERANCE  = 2e-4f; // -74 dBFS
+
+// the presets that can be rendered by the sources preceding the optimization of the audio processing, along with the
+// tolerated RMS of the difference with their renders. The dither (generated using rand() by these sources) accounts
+// for -91 dBFS, where bit reduction can quantize a differently dithered sample to an adjacent level (the renders of
+// these sources deviate as much among different rand() seeds). The oscillators modulate all channels alike, where
+// these sources advanced the oscillators once for each channel
+
+struct BaselinePreset {
+    const char* name;
+    float tolerance;
+};
+
+const BaselinePreset BASELINE_PRESETS[] = {
+    { "bypass",     5e-5f }, // -86 dBFS
+    { "downsample", 5e-5f },
+    { "playback",   5e-5f },
+    { "bitcrush",   1e-2f }, // -40 dBFS
+    { "lfo",        5e-3f }, // -46 dBFS
+};
+
+// VARIABLE_BLOCK_SIZE renders in blocks of pseudo-random size (as hosts do during automation or loop points)
+
+const int VARIABLE_BLOCK_SIZE = 0;
+const int BLOCK_SIZES[]       = { 1, 7, 64, 333, 512, VARIABLE_BLOCK_SIZE };
+
+// in real-time mode the output depends on the block size, renders are made at the block sizes hosts commonly use
+
+const int REALTIME_BLOCK_SIZES[] = { 64, 512 };
+const int AMOUNT_OF_REALTIME_BLOCK_SIZES = sizeof( REALTIME_BLOCK_SIZES ) / sizeof( int );
+
+enum Signal { SINE, NOISE, IMPULSE, SILENCE, AMOUNT_OF_SIGNALS };
+
+const char* SIGNAL_NAMES[ AMOUNT_OF_SIGNALS ] = { "sine", "noise", "impulse", "silence" };
+
+struct Preset {
+    const char* name;
+    float resampleRate;
+    float bitDepth;
+    float playbackRate;
+    float lfoRate;  // applied to all oscillators
+    float lfoDepth;
+    bool  clean;
+    Interpolator::Quality interpolation;
+    int   oversampling;
+    bool  multiThreaded;
+    float lookahead; // in milliseconds
+    int   channels;
+    bool  lfoInterpolation;
+    bool  transposedFilter;
+};
+
+// the multithreaded preset uses a wide channel layout, as narrow layouts are always processed by the calling thread
+
+const Preset PRESETS[] = {
+    { "bypass",         1.f,  1.f,  1.f,  0.f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "downsample",     .2f,  1.f,  1.f,  0.f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "bitcrush",       1.f,  .3f,  1.f,  0.f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "playback",       1.f,  1.f,  .3f,  0.f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "lfo",            .4f,  .5f,  .6f,  .3f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "clean",          .2f,  1.f,  1.f,  0.f,  .5f, true,  Interpolator::HOLD,    1, false, 0.f,  2, false, false },
+    { "linear",         1.f,  1.f,  .45f, 0.f,  .5f, false, Interpolator::LINEAR,  1, false, 0.f,  2, false, false },
+    { "hermite",        1.f,  1.f,  .45f, 0.f,  .5f, false, Interpolator::HERMITE, 1, false, 0.f,  2, false, false },
+    { "sinc",           1.f,  1.f,  .45f, 0.f,  .5f, false, Interpolator::SINC,    1, false, 0.f,  2, false, false },
+    { "oversampling2x", 1.f,  .3f,  1.f,  0.f,  .5f, false, Interpolator::HOLD,    2, false, 0.f,  2, false, false },
+    { "oversampling4x", .4f,  .3f,  .6f,  .3f,  .5f, false, Interpolator::HOLD,    4, false, 0.f,  2, false, false },
+    { "multithreaded",  .4f,  .5f,  .6f,  .3f,  .5f, false, Interpolator::HERMITE, 1, true,  0.f,  8, false, false },
+    { "lookahead",      .4f,  .3f,  .6f,  0.f,  .5f, false, Interpolator::HOLD,    1, false, 1.5f, 2, false, false },
+    { "smoothlfo",      .4f,  .5f,  .6f,  .3f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, true,  false },
+    { "transposed",     .4f,  .5f,  .6f,  .3f,  .5f, false, Interpolator::HOLD,    1, false, 0.f,  2, false, true  },
+};
+
+// deterministic (and platform independent) noise source
+
+unsigned int random( unsigned int& seed )
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+template <typename SampleType>
+void createSignal( Signal signal, std::vector<std::vector<SampleType>>& buffers )
+{
+    unsigned int seed = 1;
+    for ( size_t c = 0; c < buffers.size(); ++c ) {
+        for ( int i = 0; i < ( int ) buffers[ c ].size(); ++i ) {
+            double value = 0.0;
+            switch ( signal ) {
+                case SINE:
+                    value = .8 * sin( i * .031 * ( c + 1 ));
+                    break;
+                case NOISE:
+                    value = (( double ) random( seed ) / ( double ) 0xFFFFFF ) * 2.0 - 1.0;
+                    break;
+                case IMPULSE:
+                    value = ( i % 301 ) == c ? 1.0 : 0.0;
+                    break;
+                default:
+                    break;
+            }
+            buffers[ c ][ i ] = ( SampleType ) value;
+        }
+    }
+}
+
+void configure( PluginProcess& process, const Preset& preset )
+{
+    process.setOversampling( preset.oversampling );
+    process.setMultiThreaded( preset.multiThreaded );
+    process.limiter->setLookahead( preset.lookahead );
+    process.setCleanDownSampling( preset.clean );
+    process.setInterpolationQuality( preset.interpolation );
+    process.setLfoInterpolation( preset.lfoInterpolation );
+    process.setTransposedFilter( preset.transposedFilter );
+    process.setResampleRate( preset.resampleRate );
+    process.setPlaybackRate( preset.playbackRate );
+    process.bitCrusher->setAmount( preset.bitDepth );
+    process.setResampleLfo( preset.lfoRate, preset.lfoDepth );
+    process.setPlaybackRateLfo( preset.lfoRate, preset.lfoDepth );
+    process.bitCrusher->setLFO( preset.lfoRate, preset.lfoDepth );
+}
+
+template <typename SampleType>
+std::vector<SampleType> render( const Preset& preset, Signal signal, int blockSize, bool deterministic = true )
+{
+    const int channels = preset.channels;
+    PluginProcess process( channels );
+
+    process.setDeterministic( deterministic );
+    configure( process, preset );
+
+    std::vector<std::vector<SampleType>> input( channels, std::vector<SampleType>( FRAMES ));
+    std::vector<std::vector<SampleType>> output( channels, std::vector<SampleType>( FRAMES ));
+    createSignal<SampleType>( signal, input );
+
+    SampleType* in[ MAX_CHANNELS ];
+    SampleType* out[ MAX_CHANNELS ];
+
+    unsigned int seed = 7;
+    for ( int offset = 0, bufferSize = 0; offset < FRAMES; offset += bufferSize ) {
+        bufferSize = blockSize == VARIABLE_BLOCK_SIZE ? 1 + random( seed ) % 600 : blockSize;
+        bufferSize = std::min( bufferSize, FRAMES - offset );
+        for ( int c = 0; c < channels; ++c ) {
+            in[ c ]  = input[ c ].data() + offset;
+            out[ c ] = output[ c ].data() + offset;
+        }
+        DenormalGuard guard;
+        process.process<SampleType>( in, out, channels, channels, bufferSize, bufferSize * sizeof( SampleType ));
+    }
+
+    std::vector<SampleType> result;
+    for ( int c = 0; c < channels; ++c ) {
+        result.insert( result.end(), output[ c ].begin(), output[ c ].end());
+    }
+    return result;
+}
+
+// renders the input for given range of frames in blocks of RESTORE_BLOCK_SIZE
+
+void renderRange( PluginProcess& process, std::vector<std::vector<float>>& input, std::vector<std::vector<float>>& output, int start, int end )
+{
+    float* in[ MAX_CHANNELS ];
+    float* out[ MAX_CHANNELS ];
+
+    for ( int offset = start; offset < end; offset += RESTORE_BLOCK_SIZE ) {
+        int bufferSize = std::min( RESTORE_BLOCK_SIZE, end - offset );
+        for ( size_t c = 0; c < input.size(); ++c ) {
+            in[ c ]  = input[ c ].data() + offset;
+            out[ c ] = output[ c ].data() + offset;
+        }
+        DenormalGuard guard;
+        process.process<float>( in, out, ( int ) input.size(), ( int ) input.size(), bufferSize, bufferSize * sizeof( float ));
+    }
+}
+
+// saves the recording of an instance after rendering RESTORE_FRAMES of input and restores it into a new
+// instance (spanning multiple process cycles), after which both instances render the remaining input (which
+// should match). As the oscillator phases aren't part of the recording, this applies to presets without LFO. Neither
+// is the phase of the down sampled segments, which in deterministic mode doesn't align with the process cycles
+
+int testRestore( const Preset& preset, bool deterministic )
+{
+    const int channels = preset.channels;
+    const int frames   = RESTORE_FRAMES + FRAMES;
+
+    std::vector<std::vector<float>> input( channels, std::vector<float>( frames ));
+    std::vector<std::vector<float>> saved( channels, std::vector<float>( frames ));
+    std::vector<std::vector<float>> restored( channels, std::vector<float>( frames ));
+    createSignal<float>( SINE, input );
+
+    PluginProcess saving( channels );
+    PluginProcess restoring( channels );
+
+    for ( PluginProcess* process : { &saving, &restoring }) {
+        process->setDeterministic( deterministic );
+        process->recordingStore.prepare( channels, PluginProcess::MAX_RECORD_SECONDS, VST::SAMPLE_RATE );
+        process->recordingStore.setEnabled( true );
+        configure( *process, preset );
+
+        // the bit crusher can quantize a sample that was rounded when saving to an adjacent level
+
+        process->bitCrusher->setAmount( 1.f );
+    }
+    const char* mode = deterministic ? "deterministic" : "real-time";
+
+    renderRange( saving, input, saved, 0, RESTORE_FRAMES );
+
+    std::vector<uint8_t> data;
+    if ( !saving.recordingStore.save( data ) || !restoring.recordingStore.load( data.data(), ( uint32_t ) data.size())) {
+        printf( "FAIL %s / restore / %s : could not save and load the recording\n", preset.name, mode );
+        return 1;
+    }
+    renderRange( saving,    input, saved,    RESTORE_FRAMES, frames );
+    renderRange( restoring, input, restored, RESTORE_FRAMES, frames );
+
+    float maxError = 0.f;
+    int errorFrame = 0;
+    for ( int c = 0; c < channels; ++c ) {
+        for ( int i = RESTORE_FRAMES + RESTORE_SETTLE; i < frames; ++i ) {
+            float error = std::isfinite( restored[ c ][ i ]) ? fabs( restored[ c ][ i ] - saved[ c ][ i ]) : INFINITY;
+            if ( error > maxError ) {
+                maxError   = error;
+                errorFrame = i;
+            }
+        }
+    }
+    if ( maxError > RESTORE_TOLERANCE ) {
+        printf( "FAIL %s / restore / %s : deviation of %g at frame %d\n", preset.name, mode, maxError, errorFrame );
+        return 1;
+    }
+    return 0;
+}
+
+// a reference file holds the renders of all signals (float first, then double) as
+// consecutive blocks of planar, little endian 32-bit floats
+
+std::string referencePath( const std::string& folder, const Preset& preset, const char* suffix = "" )
+{
+    return folder + "/" + preset.name + suffix + ".bin";
+}
+
+bool readReference( const std::string& path, std::vector<float>& samples )
+{
+    FILE* file = fopen( path.c_str(), "rb" );
+    if ( file == nullptr ) {
+        return false;
+    }
+    size_t read = fread( samples.data(), sizeof( float ), samples.size(), file );
+    fclose( file );
+    return read == samples.size();
+}
+
+bool writeReference( const std::string& path, const std::vector<float>& samples )
+{
+    FILE* file = fopen( path.c_str(), "wb" );
+    if ( file == nullptr ) {
+        return false;
+    }
+    size_t written = fwrite( samples.data(), sizeof( float ), samples.size(), file );
+    fclose( file );
+    return written == samples.size();
+}
+
+// compares a render against its reference, allowing for rounding differences introduced by changes to the sources
+
+template <typename SampleType>
+int compareReference( const Preset& preset, Signal signal, const std::vector<SampleType>& result, const float* reference,
+    const char* typeName, int blockSize, const char* mode )
+{
+    float maxError = 0.f;
+    int errorIndex = 0;
+    for ( size_t i = 0; i < result.size(); ++i ) {
+        float error = std::isfinite( result[ i ]) ? fabs(( float ) result[ i ] - reference[ i ]) : INFINITY;
+        if ( error > maxError ) {
+            maxError   = error;
+            errorIndex = ( int ) i;
+        }
+    }
+    if ( maxError > TOLERANCE ) {
+        printf( "FAIL %s / %s / %s / block size %d%s : deviation of %g at channel %d, frame %d\n",
+            preset.name, SIGNAL_NAMES[ signal ], typeName, blockSize, mode, maxError, errorIndex / FRAMES, errorIndex % FRAMES
+        );
+        return 1;
+    }
+    return 0;
+}
+
+// in deterministic mode the output must be bit-identical for all block sizes, while the reference
+// comparison allows for rounding differences introduced by changes to the sources
+
+template <typename SampleType>
+int compare( const Preset& preset, Signal signal, const float* reference, const char* typeName )
+{
+    int failures = 0;
+    std::vector<SampleType> first;
+    for ( int blockSize : BLOCK_SIZES ) {
+        std::vector<SampleType> result = render<SampleType>( preset, signal, blockSize );
+        if ( first.empty()) {
+            first = result;
+        } else if ( memcmp( first.data(), result.data(), first.size() * sizeof( SampleType )) != 0 ) {
+            printf( "FAIL %s / %s / %s / block size %d : output differs from block size %d\n",
+                preset.name, SIGNAL_NAMES[ signal ], typeName, blockSize, BLOCK_SIZES[ 0 ]
+            );
+            ++failures;
+        }
+        failures += compareReference( preset, signal, result, reference, typeName, blockSize, "" );
+    }
+    return failures;
+}
+
+// the baseline references were rendered by the sources preceding the optimization of the audio processing (in
+// real-time mode, as these sources lacked a deterministic mode) and are compared by the RMS of their difference
+
+int compareBaseline( const Preset& preset, Signal signal, const std::vector<float>& result, const float* reference,
+    int blockSize, float tolerance )
+{
+    double sum = 0.0;
+    for ( size_t i = 0; i < result.size(); ++i ) {
+        double error = std::isfinite( result[ i ]) ? ( double ) result[ i ] - reference[ i ] : INFINITY;
+        sum += error * error;
+    }
+    float rms = ( float ) sqrt( sum / ( double ) result.size());
+    if ( !( rms <= tolerance )) {
+        printf( "FAIL %s / %s / block size %d / baseline : RMS deviation of %g\n", preset.name, SIGNAL_NAMES[ signal ], blockSize, rms );
+        return 1;
+    }
+    return 0;
+}
+
+int compareBaseline( const Preset& preset, const std::vector<float>& reference, float tolerance )
+{
+    const size_t signalSize = preset.channels * FRAMES;
+    int failures = 0;
+
+    for ( int b = 0; b < AMOUNT_OF_REALTIME_BLOCK_SIZES; ++b ) {
+        for ( int s = 0; s < AMOUNT_OF_SIGNALS; ++s ) {
+            std::vector<float> result = render<float>( preset, ( Signal ) s, REALTIME_BLOCK_SIZES[ b ], false );
+            failures += compareBaseline( preset, ( Signal ) s, result, reference.data() + ( b * AMOUNT_OF_SIGNALS + s ) * signalSize,
+                REALTIME_BLOCK_SIZES[ b ], tolerance
+            );
+        }
+    }
+    return failures;
+}
+
+// a real-time reference file holds the renders of all signals (float first, then double) for each of the REALTIME_BLOCK_SIZES
+
+void renderReference( const Preset& preset, const int* blockSizes, int amountOfBlockSizes, bool deterministic, std::vector<float>& reference )
+{
+    const size_t signalSize = preset.channels * FRAMES;
+
+    for ( int b = 0; b < amountOfBlockSizes; ++b ) {
+        float* blockReference = reference.data() + b * signalSize * AMOUNT_OF_SIGNALS * 2;
+        for ( int s = 0; s < AMOUNT_OF_SIGNALS; ++s ) {
+            std::vector<float>  f = render<float> ( preset, ( Signal ) s, blockSizes[ b ], deterministic );
+            std::vector<double> d = render<double>( preset, ( Signal ) s, blockSizes[ b ], deterministic );
+            std::copy( f.begin(), f.end(), blockReference + s * signalSize );
+            std::copy( d.begin(), d.end(), blockReference + ( AMOUNT_OF_SIGNALS + s ) * signalSize );
+        }
+    }
+}
+
+// in real-time mode the output depends on the block size, each block size is compared against its own reference
+
+int compareRealtime( const Preset& preset, const std::vector<float>& reference )
+{
+    const size_t signalSize = preset.channels * FRAMES;
+    int failures = 0;
+
+    for ( int b = 0; b < AMOUNT_OF_REALTIME_BLOCK_SIZES; ++b ) {
+        const float* blockReference = reference.data() + b * signalSize * AMOUNT_OF_SIGNALS * 2;
+        for ( int s = 0; s < AMOUNT_OF_SIGNALS; ++s ) {
+            std::vector<float>  f = render<float> ( preset, ( Signal ) s, REALTIME_BLOCK_SIZES[ b ], false );
+            std::vector<double> d = render<double>( preset, ( Signal ) s, REALTIME_BLOCK_SIZES[ b ], false );
+            failures += compareReference( preset, ( Signal ) s, f, blockReference + s * signalSize, "float", REALTIME_BLOCK_SIZES[ b ], " / real-time" );
+            failures += compareReference( preset, ( Signal ) s, d, blockReference + ( AMOUNT_OF_SIGNALS + s ) * signalSize, "double", REALTIME_BLOCK_SIZES[ b ], " / real-time" );
+        }
+    }
+    return failures;
+}
+
+const BaselinePreset* getBaselinePreset( const Preset& preset )
+{
+    for ( const BaselinePreset& baselinePreset : BASELINE_PRESETS ) {
+        if ( strcmp( baselinePreset.name, preset.name ) == 0 ) {
+            return &baselinePreset;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 ) {
+        printf( "usage : %s <reference folder> [--generate]\n", argv[ 0 ]);
+        return 1;
+    }
+    std::string folder = argv[ 1 ];
+    bool generate = argc > 2 && strcmp( argv[ 2 ], "--generate" ) == 0;
+
+    int failures = 0;
+
+    for ( const Preset& preset : PRESETS ) {
+        const size_t signalSize = preset.channels * FRAMES;
+        std::vector<float> reference( signalSize * AMOUNT_OF_SIGNALS * 2 );
+        std::vector<float> realtimeReference( reference.size() * AMOUNT_OF_REALTIME_BLOCK_SIZES );
+        std::string path = referencePath( folder, preset );
+        std::string realtimePath = referencePath( folder, preset, ".realtime" );
+
+        if ( generate ) {
+            renderReference( preset, BLOCK_SIZES, 1, true, reference );
+            renderReference( preset, REALTIME_BLOCK_SIZES, AMOUNT_OF_REALTIME_BLOCK_SIZES, false, realtimeReference );
+
+            for ( const std::string& p : { path, realtimePath }) {
+                if ( !writeReference( p, p == path ? reference : realtimeReference )) {
+                    printf( "FAIL could not write %s\n", p.c_str());
+                    return 1;
+                }
+                printf( "wrote %s\n", p.c_str());
+            }
+            continue;
+        }
+
+        if ( !readReference( path, reference ) || !readReference( realtimePath, realtimeReference )) {
+            printf( "FAIL could not read the references of %s\n", preset.name );
+            ++failures;
+            continue;
+        }
+        for ( int s = 0; s < AMOUNT_OF_SIGNALS; ++s ) {
+            failures += compare<float> ( preset, ( Signal ) s, reference.data() + s * signalSize, "float" );
+            failures += compare<double>( preset, ( Signal ) s, reference.data() + ( AMOUNT_OF_SIGNALS + s ) * signalSize, "double" );
+        }
+        failures += compareRealtime( preset, realtimeReference );
+
+        const BaselinePreset* baselinePreset = getBaselinePreset( preset );
+        if ( baselinePreset != nullptr ) {
+            std::vector<float> baselineReference( signalSize * AMOUNT_OF_SIGNALS * AMOUNT_OF_REALTIME_BLOCK_SIZES );
+            if ( !readReference( referencePath( folder + "/baseline", preset ), baselineReference )) {
+                printf( "FAIL could not read the baseline reference of %s\n", preset.name );
+                ++failures;
+            } else {
+                failures += compareBaseline( preset, baselineReference, baselinePreset->tolerance );
+            }
+        }
+
+        if ( preset.playbackRate < 1.f && preset.lfoRate == 0.f ) {
+            failures += testRestore( preset, false );
+            if ( preset.resampleRate == 1.f ) {
+                failures += testRestore( preset, true );
+            }
+        }
+    }
+    if ( !generate ) {
+        printf( failures == 0 ? "all renders match their reference\n" : "%d render(s) deviate from their reference\n", failures );
+    }
+    return failures == 0 ? 0 : 1;
+}